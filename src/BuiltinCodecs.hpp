@@ -0,0 +1,90 @@
+#pragma once
+
+#include "stbipp/Image.hpp"
+#include "stbipp/ImageExporter.hpp"
+#include "stbipp/ImageFormat.hpp"
+
+#include <string>
+
+namespace stbipp
+{
+/**
+ * @brief Retrieve the lower case extension of a path
+ * @param[in] path The path
+ * @return The extension without the dot, empty if the path has none
+ */
+std::string fileExtension(const std::string& path);
+
+/**
+ * @brief Decode any file format supported by stb_image
+ */
+bool decodeStbImage(const std::string& path, Image& image, const ImageFormat pixelFormat);
+
+/**
+ * @brief Encode a PNG file with the stbipp PNG encoder
+ */
+bool encodePngImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Encode a BMP file with stb_image_write
+ */
+bool encodeBmpImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Encode a TGA file with stb_image_write
+ */
+bool encodeTgaImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Encode a JPEG file with stb_image_write
+ */
+bool encodeJpgImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Encode an HDR file with stb_image_write
+ */
+bool encodeHdrImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Decode a QOI file with the stbipp QOI decoder
+ */
+bool decodeQoiImage(const std::string& path, Image& image, const ImageFormat pixelFormat);
+
+/**
+ * @brief Encode a QOI file with the stbipp QOI encoder, gray images are stored as RGB(A)
+ */
+bool encodeQoiImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+/**
+ * @brief Decode a raw stbipp file, the stored precision is kept and the channels are converted to the requested format
+ * as stb_image converts them
+ */
+bool decodeRawImage(const std::string& path, Image& image, const ImageFormat pixelFormat);
+
+/**
+ * @brief Encode a raw stbipp file with 32 bits floating point channels
+ */
+bool encodeRawImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options);
+
+} // namespace stbipp
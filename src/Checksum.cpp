@@ -0,0 +1,62 @@
+#include "Checksum.hpp"
+
+#include <array>
+
+namespace
+{
+using CrcTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+/**
+ * @brief Tables of the slicing-by-8 algorithm, processing 8 bytes per iteration
+ */
+const CrcTables& crcTables()
+{
+    static const CrcTables tables = []() {
+        CrcTables values{};
+        for(std::uint32_t index = 0; index < 256; ++index)
+        {
+            std::uint32_t value = index;
+            for(int bit = 0; bit < 8; ++bit)
+            {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            values[0][index] = value;
+        }
+        for(std::uint32_t index = 0; index < 256; ++index)
+        {
+            for(std::size_t slice = 1; slice < values.size(); ++slice)
+            {
+                const auto previous = values[slice - 1][index];
+                values[slice][index] = values[0][previous & 0xFF] ^ (previous >> 8);
+            }
+        }
+        return values;
+    }();
+    return tables;
+}
+
+} // namespace
+
+namespace stbipp
+{
+std::uint32_t crc32(const unsigned char* data, std::size_t size, std::uint32_t crc)
+{
+    const auto& tables = crcTables();
+    crc = ~crc;
+    for(; size >= 8; size -= 8, data += 8)
+    {
+        const std::uint32_t low =
+          crc ^ (static_cast<std::uint32_t>(data[0]) | static_cast<std::uint32_t>(data[1]) << 8 |
+                 static_cast<std::uint32_t>(data[2]) << 16 | static_cast<std::uint32_t>(data[3]) << 24);
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^
+              tables[4][low >> 24] ^ tables[3][data[4]] ^ tables[2][data[5]] ^ tables[1][data[6]] ^
+              tables[0][data[7]];
+    }
+    for(; size > 0; --size, ++data)
+    {
+        crc = tables[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace stbipp
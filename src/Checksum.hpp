@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace stbipp
+{
+/**
+ * @brief Compute the CRC-32 (ISO 3309, as used by PNG and zlib) of a buffer
+ * @param[in] data Pointer to the data
+ * @param[in] size Number of bytes to process
+ * @param[in] crc CRC of the data preceding this buffer, to compute the CRC of a stream piece by piece
+ * @return The CRC of all the data processed
+ */
+std::uint32_t crc32(const unsigned char* data, std::size_t size, std::uint32_t crc = 0);
+
+} // namespace stbipp
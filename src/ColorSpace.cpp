@@ -0,0 +1,503 @@
+#include "stbipp/ColorSpace.hpp"
+
+#include "FastMath.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Number of pixels converted by each task of the multithreaded image conversions
+constexpr std::size_t grainSize = 16384;
+// Number of colors converted to RGB then to the destination space before moving to the next ones, they stay in the
+// L1 cache between both passes
+constexpr std::size_t blockSize = 1024;
+
+/**
+ * @brief Weights of the red, green and blue channels in the luma
+ */
+struct LumaWeights
+{
+    float red;
+    float green;
+    float blue;
+};
+
+LumaWeights lumaWeights(stbipp::LumaCoefficients coefficients)
+{
+    if(coefficients == stbipp::LumaCoefficients::BT601)
+    {
+        return LumaWeights{0.299f, 0.587f, 0.114f};
+    }
+    return LumaWeights{0.2126f, 0.7152f, 0.0722f};
+}
+
+#if defined(STBIPP_SIMD_SSE2)
+/**
+ * @brief Four values of the same channel of four colors, the kernels are written once for these and for floats
+ */
+struct Value
+{
+    __m128 lanes;
+};
+
+inline Value broadcast(float value)
+{
+    return Value{_mm_set1_ps(value)};
+}
+
+inline Value operator+(Value lhs, Value rhs)
+{
+    return Value{_mm_add_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value operator-(Value lhs, Value rhs)
+{
+    return Value{_mm_sub_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value operator*(Value lhs, Value rhs)
+{
+    return Value{_mm_mul_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value operator/(Value lhs, Value rhs)
+{
+    return Value{_mm_div_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value minimum(Value lhs, Value rhs)
+{
+    return Value{_mm_min_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value maximum(Value lhs, Value rhs)
+{
+    return Value{_mm_max_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value absolute(Value value)
+{
+    return Value{_mm_andnot_ps(_mm_set1_ps(-0.0f), value.lanes)};
+}
+
+inline Value fraction(Value value)
+{
+    return Value{_mm_sub_ps(value.lanes, stbipp::detail::floorApprox(value.lanes))};
+}
+
+// The comparisons return lane masks, select picks the lanes of ifTrue where the mask is set
+inline Value isGreater(Value lhs, Value rhs)
+{
+    return Value{_mm_cmpgt_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value isGreaterOrEqual(Value lhs, Value rhs)
+{
+    return Value{_mm_cmpge_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value isEqual(Value lhs, Value rhs)
+{
+    return Value{_mm_cmpeq_ps(lhs.lanes, rhs.lanes)};
+}
+
+inline Value select(Value mask, Value ifTrue, Value ifFalse)
+{
+    return Value{stbipp::detail::select(mask.lanes, ifTrue.lanes, ifFalse.lanes)};
+}
+#else
+// Without SSE2 the kernels are instantiated on single floats, with the same operations
+using Value = float;
+
+inline Value broadcast(float value)
+{
+    return value;
+}
+
+inline Value minimum(Value lhs, Value rhs)
+{
+    return lhs < rhs ? lhs : rhs;
+}
+
+inline Value maximum(Value lhs, Value rhs)
+{
+    return lhs > rhs ? lhs : rhs;
+}
+
+inline Value absolute(Value value)
+{
+    return std::fabs(value);
+}
+
+inline Value fraction(Value value)
+{
+    return value - std::floor(value);
+}
+
+inline bool isGreater(Value lhs, Value rhs)
+{
+    return lhs > rhs;
+}
+
+inline bool isGreaterOrEqual(Value lhs, Value rhs)
+{
+    return lhs >= rhs;
+}
+
+inline bool isEqual(Value lhs, Value rhs)
+{
+    return lhs == rhs;
+}
+
+inline Value select(bool mask, Value ifTrue, Value ifFalse)
+{
+    return mask ? ifTrue : ifFalse;
+}
+#endif
+
+/**
+ * @brief Full range Y'CbCr encoding, the chroma are centered on 0.5
+ */
+struct RgbToYCbCr
+{
+    LumaWeights weights;
+
+    void operator()(Value& r, Value& g, Value& b) const
+    {
+        const Value y = broadcast(weights.red) * r + broadcast(weights.green) * g + broadcast(weights.blue) * b;
+        const Value cb = broadcast(0.5f) + (b - y) * broadcast(0.5f / (1.0f - weights.blue));
+        const Value cr = broadcast(0.5f) + (r - y) * broadcast(0.5f / (1.0f - weights.red));
+        r = y;
+        g = cb;
+        b = cr;
+    }
+};
+
+struct YCbCrToRgb
+{
+    LumaWeights weights;
+
+    void operator()(Value& y, Value& cb, Value& cr) const
+    {
+        const Value red = y + (cr - broadcast(0.5f)) * broadcast(2.0f - 2.0f * weights.red);
+        const Value blue = y + (cb - broadcast(0.5f)) * broadcast(2.0f - 2.0f * weights.blue);
+        const Value green =
+          (y - broadcast(weights.red) * red - broadcast(weights.blue) * blue) * broadcast(1.0f / weights.green);
+        y = red;
+        cb = green;
+        cr = blue;
+    }
+};
+
+/**
+ * @brief Hue in turns of colors whose largest channel and chroma (largest minus smallest channel) are known
+ */
+inline Value hue(Value r, Value g, Value b, Value largest, Value chroma)
+{
+    const Value zero = broadcast(0.0f);
+    const auto hasHue = isGreater(chroma, zero);
+    const Value inverseChroma = broadcast(1.0f) / select(hasHue, chroma, broadcast(1.0f));
+    Value redHue = (g - b) * inverseChroma;
+    redHue = select(isGreater(zero, redHue), redHue + broadcast(6.0f), redHue);
+    const Value greenHue = (b - r) * inverseChroma + broadcast(2.0f);
+    const Value blueHue = (r - g) * inverseChroma + broadcast(4.0f);
+    Value sextant = select(isEqual(largest, r), redHue, select(isEqual(largest, g), greenHue, blueHue));
+    sextant = select(isGreaterOrEqual(sextant, broadcast(6.0f)), sextant - broadcast(6.0f), sextant);
+    return select(hasHue, sextant * broadcast(1.0f / 6.0f), zero);
+}
+
+struct RgbToHsv
+{
+    void operator()(Value& r, Value& g, Value& b) const
+    {
+        const Value largest = maximum(r, maximum(g, b));
+        const Value chroma = largest - minimum(r, minimum(g, b));
+        const Value zero = broadcast(0.0f);
+        const auto isLit = isGreater(largest, zero);
+        const Value saturation = select(isLit, chroma / select(isLit, largest, broadcast(1.0f)), zero);
+        r = hue(r, g, b, largest, chroma);
+        g = saturation;
+        b = largest;
+    }
+};
+
+struct HsvToRgb
+{
+    /**
+     * @brief Channel n (5 for red, 3 for green, 1 for blue) of a color with the hue in sextants
+     */
+    static Value channel(float n, Value sextant, Value saturation, Value value)
+    {
+        Value k = broadcast(n) + sextant;
+        k = select(isGreaterOrEqual(k, broadcast(6.0f)), k - broadcast(6.0f), k);
+        const Value ramp = maximum(minimum(minimum(k, broadcast(4.0f) - k), broadcast(1.0f)), broadcast(0.0f));
+        return value - value * saturation * ramp;
+    }
+
+    void operator()(Value& h, Value& s, Value& v) const
+    {
+        const Value sextant = fraction(h) * broadcast(6.0f);
+        const Value red = channel(5.0f, sextant, s, v);
+        const Value green = channel(3.0f, sextant, s, v);
+        const Value blue = channel(1.0f, sextant, s, v);
+        h = red;
+        s = green;
+        v = blue;
+    }
+};
+
+struct RgbToHsl
+{
+    void operator()(Value& r, Value& g, Value& b) const
+    {
+        const Value largest = maximum(r, maximum(g, b));
+        const Value smallest = minimum(r, minimum(g, b));
+        const Value chroma = largest - smallest;
+        const Value lightness = (largest + smallest) * broadcast(0.5f);
+        const Value zero = broadcast(0.0f);
+        const Value one = broadcast(1.0f);
+        const auto hasHue = isGreater(chroma, zero);
+        const Value range = one - absolute(lightness + lightness - one);
+        const Value saturation = select(hasHue, chroma / select(hasHue, range, one), zero);
+        r = hue(r, g, b, largest, chroma);
+        g = saturation;
+        b = lightness;
+    }
+};
+
+struct HslToRgb
+{
+    /**
+     * @brief Channel n (0 for red, 8 for green, 4 for blue) of a color with the hue in twelfths of a turn
+     */
+    static Value channel(float n, Value twelfth, Value amplitude, Value lightness)
+    {
+        Value k = broadcast(n) + twelfth;
+        k = select(isGreaterOrEqual(k, broadcast(12.0f)), k - broadcast(12.0f), k);
+        const Value ramp = maximum(minimum(minimum(k - broadcast(3.0f), broadcast(9.0f) - k), broadcast(1.0f)),
+                                   broadcast(-1.0f));
+        return lightness - amplitude * ramp;
+    }
+
+    void operator()(Value& h, Value& s, Value& l) const
+    {
+        const Value twelfth = fraction(h) * broadcast(12.0f);
+        const Value amplitude = s * minimum(l, broadcast(1.0f) - l);
+        const Value red = channel(0.0f, twelfth, amplitude, l);
+        const Value green = channel(8.0f, twelfth, amplitude, l);
+        const Value blue = channel(4.0f, twelfth, amplitude, l);
+        h = red;
+        s = green;
+        l = blue;
+    }
+};
+
+struct RgbToLuminance
+{
+    LumaWeights weights;
+
+    void operator()(Value& r, Value& g, Value& b) const
+    {
+        const Value y = broadcast(weights.red) * r + broadcast(weights.green) * g + broadcast(weights.blue) * b;
+        r = y;
+        g = y;
+        b = y;
+    }
+};
+
+/**
+ * @brief Apply a kernel to the red, green and blue channels of colors, the alpha channel is copied
+ * With SSE2 instructions the colors are transposed four by four so each lane of the kernel holds one color.
+ */
+template<class Kernel>
+void applyKernel(const stbipp::Color4f* source, stbipp::Color4f* destination, std::size_t count, const Kernel& kernel)
+{
+#if defined(STBIPP_SIMD_SSE2)
+    const auto convertQuad = [&kernel](const stbipp::Color4f* input, stbipp::Color4f* output) {
+        Value r{_mm_loadu_ps(input[0].data())};
+        Value g{_mm_loadu_ps(input[1].data())};
+        Value b{_mm_loadu_ps(input[2].data())};
+        __m128 a = _mm_loadu_ps(input[3].data());
+        _MM_TRANSPOSE4_PS(r.lanes, g.lanes, b.lanes, a);
+        kernel(r, g, b);
+        _MM_TRANSPOSE4_PS(r.lanes, g.lanes, b.lanes, a);
+        _mm_storeu_ps(output[0].data(), r.lanes);
+        _mm_storeu_ps(output[1].data(), g.lanes);
+        _mm_storeu_ps(output[2].data(), b.lanes);
+        _mm_storeu_ps(output[3].data(), a);
+    };
+    std::size_t index = 0;
+    for(; index + 4 <= count; index += 4)
+    {
+        convertQuad(source + index, destination + index);
+    }
+    if(index < count)
+    {
+        stbipp::Color4f quad[4];
+        std::copy(source + index, source + count, quad);
+        convertQuad(quad, quad);
+        std::copy(quad, quad + (count - index), destination + index);
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const stbipp::Color4f color = source[index];
+        float r = color.r();
+        float g = color.g();
+        float b = color.b();
+        kernel(r, g, b);
+        destination[index] = stbipp::Color4f(r, g, b, color.a());
+    }
+#endif
+}
+
+void convertToRgb(const stbipp::Color4f* source,
+                  stbipp::Color4f* destination,
+                  std::size_t count,
+                  stbipp::ColorSpace from)
+{
+    switch(from)
+    {
+        case stbipp::ColorSpace::YCBCR_BT601:
+            applyKernel(source, destination, count, YCbCrToRgb{lumaWeights(stbipp::LumaCoefficients::BT601)});
+            break;
+        case stbipp::ColorSpace::YCBCR_BT709:
+            applyKernel(source, destination, count, YCbCrToRgb{lumaWeights(stbipp::LumaCoefficients::BT709)});
+            break;
+        case stbipp::ColorSpace::HSV: applyKernel(source, destination, count, HsvToRgb{}); break;
+        case stbipp::ColorSpace::HSL: applyKernel(source, destination, count, HslToRgb{}); break;
+        case stbipp::ColorSpace::RGB: stbipp::copyPixels(source, destination, count); break;
+    }
+}
+
+void convertFromRgb(const stbipp::Color4f* source,
+                    stbipp::Color4f* destination,
+                    std::size_t count,
+                    stbipp::ColorSpace to)
+{
+    switch(to)
+    {
+        case stbipp::ColorSpace::YCBCR_BT601:
+            applyKernel(source, destination, count, RgbToYCbCr{lumaWeights(stbipp::LumaCoefficients::BT601)});
+            break;
+        case stbipp::ColorSpace::YCBCR_BT709:
+            applyKernel(source, destination, count, RgbToYCbCr{lumaWeights(stbipp::LumaCoefficients::BT709)});
+            break;
+        case stbipp::ColorSpace::HSV: applyKernel(source, destination, count, RgbToHsv{}); break;
+        case stbipp::ColorSpace::HSL: applyKernel(source, destination, count, RgbToHsl{}); break;
+        case stbipp::ColorSpace::RGB: stbipp::copyPixels(source, destination, count); break;
+    }
+}
+
+/**
+ * @brief Apply a float conversion to an 8 bits image in place, each task converts its rows through a float buffer
+ */
+template<class ColorType, class Function>
+void convertTypedImage(stbipp::TypedImage<ColorType>& image, unsigned int threadCount, Function function)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    ColorType* pixels = image.data();
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(image.height()),
+      std::max<std::size_t>(1, grainSize / std::max<std::size_t>(width, 1)),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<stbipp::Color4f> buffer(width);
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              ColorType* rowPixels = pixels + row * width;
+              stbipp::convertPixels(rowPixels, buffer.data(), width);
+              function(buffer.data(), width);
+              stbipp::convertPixels(buffer.data(), rowPixels, width);
+          }
+      },
+      threadCount);
+}
+
+} // namespace
+
+namespace stbipp
+{
+void convertColorSpace(const Color4f* source, Color4f* destination, std::size_t count, ColorSpace from, ColorSpace to)
+{
+    if(from == to)
+    {
+        copyPixels(source, destination, count);
+        return;
+    }
+    for(std::size_t block = 0; block < count; block += blockSize)
+    {
+        const std::size_t blockCount = std::min(blockSize, count - block);
+        const Color4f* rgb = source + block;
+        if(from != ColorSpace::RGB)
+        {
+            convertToRgb(rgb, destination + block, blockCount, from);
+            rgb = destination + block;
+        }
+        convertFromRgb(rgb, destination + block, blockCount, to);
+    }
+}
+
+void convertColorSpace(Image& image, ColorSpace from, ColorSpace to, unsigned int threadCount)
+{
+    Color4f* pixels = image.data();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+      grainSize,
+      [pixels, from, to](std::size_t begin, std::size_t end) {
+          convertColorSpace(pixels + begin, pixels + begin, end - begin, from, to);
+      },
+      threadCount);
+}
+
+void convertColorSpace(TypedImage<Color3uc>& image, ColorSpace from, ColorSpace to, unsigned int threadCount)
+{
+    convertTypedImage(image, threadCount, [from, to](Color4f* colors, std::size_t count) {
+        convertColorSpace(colors, colors, count, from, to);
+    });
+}
+
+void convertColorSpace(TypedImage<Color4uc>& image, ColorSpace from, ColorSpace to, unsigned int threadCount)
+{
+    convertTypedImage(image, threadCount, [from, to](Color4f* colors, std::size_t count) {
+        convertColorSpace(colors, colors, count, from, to);
+    });
+}
+
+void computeLuminance(const Color4f* source, float* destination, std::size_t count, LumaCoefficients coefficients)
+{
+    const LumaWeights weights = lumaWeights(coefficients);
+    const Color4f weightColor(weights.red, weights.green, weights.blue, 0.0f);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        destination[index] = dot(source[index], weightColor);
+    }
+}
+
+void convertToLuminance(Image& image, LumaCoefficients coefficients, unsigned int threadCount)
+{
+    const RgbToLuminance kernel{lumaWeights(coefficients)};
+    Color4f* pixels = image.data();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+      grainSize,
+      [pixels, &kernel](std::size_t begin, std::size_t end) {
+          applyKernel(pixels + begin, pixels + begin, end - begin, kernel);
+      },
+      threadCount);
+}
+
+void convertToLuminance(TypedImage<Color4uc>& image, LumaCoefficients coefficients, unsigned int threadCount)
+{
+    const RgbToLuminance kernel{lumaWeights(coefficients)};
+    convertTypedImage(image, threadCount, [&kernel](Color4f* colors, std::size_t count) {
+        applyKernel(colors, colors, count, kernel);
+    });
+}
+
+} // namespace stbipp
@@ -0,0 +1,308 @@
+#include "stbipp/Comparison.hpp"
+
+#include "stbipp/Convolution.hpp"
+#include "stbipp/ImageExpression.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// Number of pixels reduced by each task of the thread pool
+constexpr std::size_t grainSize = 65536;
+// Number of pixels reduced in single precision before being added in double precision
+constexpr std::size_t blockSize = 256;
+// Gaussian window of the structural similarity (Wang et al.)
+constexpr float ssimSigma = 1.5f;
+constexpr int ssimRadius = 5;
+// Stabilizing constants (0.01 L)^2 and (0.03 L)^2 for a peak value L of 1
+constexpr float ssimConstant1 = 0.0001f;
+constexpr float ssimConstant2 = 0.0009f;
+
+/**
+ * @brief Partial sums of a range of pixels
+ */
+struct Sums
+{
+    double values[4]{};
+    stbipp::Color4f maximum{};
+
+    void add(const stbipp::Color4f& blockSum)
+    {
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            values[channel] += blockSum[channel];
+        }
+    }
+
+    void merge(const Sums& other)
+    {
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            values[channel] += other.values[channel];
+        }
+        maximum = stbipp::maximum(maximum, other.maximum);
+    }
+};
+
+/**
+ * @brief Color of the heatmap for an absolute error scaled to [0, 1], from black to red, yellow and white
+ */
+stbipp::Color4f heatColor(const stbipp::Color4f& error, float scale)
+{
+    const float largest = std::max(std::max(error.r(), error.g()), std::max(error.b(), error.a()));
+    const float heat = std::min(largest * scale, 1.0f) * 3.0f;
+    // The alpha ramp starts at -1 so it is always clamped to 1
+    return stbipp::clamp(stbipp::Color4f(heat) - stbipp::Color4f(0.0f, 1.0f, 2.0f, -1.0f), 0.0f, 1.0f);
+}
+
+/**
+ * @brief Sum the squared differences of a range of pixels and keep the largest absolute difference
+ * @param[in] lhs The pixels of the first image
+ * @param[in] rhs The pixels of the second image
+ * @param[in] count Number of pixels
+ * @param[in,out] sums The partial sums updated
+ * @param[out] heatmap count heatmap pixels written, nullptr to skip the heatmap
+ * @param[in] heatmapScale Inverse of the error drawn in white
+ */
+void accumulateErrors(const stbipp::Color4f* lhs,
+                      const stbipp::Color4f* rhs,
+                      std::size_t count,
+                      Sums& sums,
+                      stbipp::Color4f* heatmap,
+                      float heatmapScale)
+{
+    for(std::size_t block = 0; block < count; block += blockSize)
+    {
+        const std::size_t blockEnd = std::min(block + blockSize, count);
+        stbipp::Color4f squaredErrors{};
+        for(std::size_t index = block; index < blockEnd; ++index)
+        {
+            const stbipp::Color4f difference = lhs[index] - rhs[index];
+            squaredErrors += difference * difference;
+            const stbipp::Color4f error = stbipp::maximum(difference, -difference);
+            sums.maximum = stbipp::maximum(sums.maximum, error);
+            if(heatmap != nullptr)
+            {
+                heatmap[index] = heatColor(error, heatmapScale);
+            }
+        }
+        sums.add(squaredErrors);
+    }
+}
+
+/**
+ * @brief Sum the structural similarity of a range of pixels from the local statistics of both images
+ */
+void accumulateSimilarity(const stbipp::Color4f* lhsMean,
+                          const stbipp::Color4f* rhsMean,
+                          const stbipp::Color4f* lhsSquareMean,
+                          const stbipp::Color4f* rhsSquareMean,
+                          const stbipp::Color4f* productMean,
+                          std::size_t count,
+                          Sums& sums)
+{
+    const stbipp::Color4f constant1(ssimConstant1);
+    const stbipp::Color4f constant2(ssimConstant2);
+    for(std::size_t block = 0; block < count; block += blockSize)
+    {
+        const std::size_t blockEnd = std::min(block + blockSize, count);
+        stbipp::Color4f similarity{};
+        for(std::size_t index = block; index < blockEnd; ++index)
+        {
+            const stbipp::Color4f meanProduct = lhsMean[index] * rhsMean[index];
+            const stbipp::Color4f lhsMeanSquare = lhsMean[index] * lhsMean[index];
+            const stbipp::Color4f rhsMeanSquare = rhsMean[index] * rhsMean[index];
+            const stbipp::Color4f covariance = productMean[index] - meanProduct;
+            const stbipp::Color4f variances =
+              lhsSquareMean[index] - lhsMeanSquare + (rhsSquareMean[index] - rhsMeanSquare);
+            similarity += ((meanProduct + meanProduct + constant1) * (covariance + covariance + constant2)) /
+                          ((lhsMeanSquare + rhsMeanSquare + constant1) * (variances + constant2));
+        }
+        sums.add(similarity);
+    }
+}
+
+/**
+ * @brief Reduce the pixels of images over several threads, each chunk has its own partial sums merged in order
+ * @param[in] pixelCount Number of pixels
+ * @param[in] threadCount Maximum number of threads used
+ * @param[in] function Called with the first pixel, the number of pixels and the partial sums of each chunk
+ * @return The sums of all the chunks
+ */
+template<class Function>
+Sums reduceChunks(std::size_t pixelCount, unsigned int threadCount, Function function)
+{
+    std::vector<Sums> partials((pixelCount + grainSize - 1) / grainSize);
+    stbipp::parallelFor(
+      0,
+      pixelCount,
+      grainSize,
+      [&partials, &function](std::size_t begin, std::size_t end) {
+          function(begin, end - begin, partials[begin / grainSize]);
+      },
+      threadCount);
+
+    Sums total;
+    for(const auto& partial: partials)
+    {
+        total.merge(partial);
+    }
+    return total;
+}
+
+/**
+ * @brief Mean structural similarity of two images of the same dimensions
+ */
+stbipp::Color4f structuralSimilarity(const stbipp::Image& lhs, const stbipp::Image& rhs, unsigned int threadCount)
+{
+    const stbipp::Kernel1D window = stbipp::Kernel1D::gaussian(ssimSigma, ssimRadius);
+    stbipp::ConvolutionOptions convolution;
+    convolution.border = stbipp::BorderMode::MIRROR;
+    convolution.threadCount = threadCount;
+    const auto localMean = [&](const stbipp::Image& image) {
+        return stbipp::convolveSeparable(image, window, window, convolution);
+    };
+    // Each product is only alive until its local mean is computed
+    const auto localProductMean = [&](const stbipp::Image& first, const stbipp::Image& second) {
+        stbipp::Image product;
+        stbipp::evaluate(first * second, product, threadCount);
+        return localMean(product);
+    };
+    const stbipp::Image lhsMean = localMean(lhs);
+    const stbipp::Image rhsMean = localMean(rhs);
+    const stbipp::Image lhsSquareMean = localProductMean(lhs, lhs);
+    const stbipp::Image rhsSquareMean = localProductMean(rhs, rhs);
+    const stbipp::Image productMean = localProductMean(lhs, rhs);
+
+    const std::size_t pixelCount = static_cast<std::size_t>(lhs.width()) * static_cast<std::size_t>(lhs.height());
+    const Sums sums = reduceChunks(pixelCount, threadCount, [&](std::size_t first, std::size_t count, Sums& partial) {
+        accumulateSimilarity(lhsMean.data() + first,
+                             rhsMean.data() + first,
+                             lhsSquareMean.data() + first,
+                             rhsSquareMean.data() + first,
+                             productMean.data() + first,
+                             count,
+                             partial);
+    });
+    stbipp::Color4f similarity;
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        similarity[channel] = static_cast<float>(sums.values[channel] / static_cast<double>(pixelCount));
+    }
+    return similarity;
+}
+
+/**
+ * @brief Check if the absolute differences of a range of pixels are all lower or equal to a tolerance
+ */
+bool isRangeWithinTolerance(const stbipp::Color4f* lhs, const stbipp::Color4f* rhs, std::size_t count, float tolerance)
+{
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 limit = _mm_set1_ps(tolerance);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 rejected = _mm_setzero_ps();
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const __m128 difference = _mm_sub_ps(_mm_loadu_ps(lhs[index].data()), _mm_loadu_ps(rhs[index].data()));
+        // Not lower or equal is also true for NaN values
+        rejected = _mm_or_ps(rejected, _mm_cmpnle_ps(_mm_andnot_ps(signMask, difference), limit));
+    }
+    return _mm_movemask_ps(rejected) == 0;
+#else
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            if(!(std::fabs(lhs[index][channel] - rhs[index][channel]) <= tolerance))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace
+
+namespace stbipp
+{
+ImageComparison compareImages(const Image& lhs, const Image& rhs, const ComparisonOptions& options)
+{
+    if(lhs.width() != rhs.width() || lhs.height() != rhs.height())
+    {
+        throw std::invalid_argument("Only images of the same dimensions can be compared");
+    }
+    ImageComparison comparison;
+    const std::size_t pixelCount = static_cast<std::size_t>(lhs.width()) * static_cast<std::size_t>(lhs.height());
+    if(pixelCount == 0)
+    {
+        return comparison;
+    }
+    if(options.heatmap)
+    {
+        comparison.heatmap = Image(lhs.width(), lhs.height());
+    }
+
+    Color4f* heatmap = options.heatmap ? comparison.heatmap.data() : nullptr;
+    const float heatmapScale = options.heatmapMaximum > 0.0f ? 1.0f / options.heatmapMaximum : 0.0f;
+    const Sums errors =
+      reduceChunks(pixelCount, options.threadCount, [&](std::size_t first, std::size_t count, Sums& partial) {
+          accumulateErrors(lhs.data() + first,
+                           rhs.data() + first,
+                           count,
+                           partial,
+                           heatmap != nullptr ? heatmap + first : nullptr,
+                           heatmapScale);
+      });
+    comparison.maximumAbsoluteError = errors.maximum;
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        const double meanSquaredError = errors.values[channel] / static_cast<double>(pixelCount);
+        comparison.meanSquaredError[channel] = static_cast<float>(meanSquaredError);
+        comparison.peakSignalToNoiseRatio[channel] = meanSquaredError > 0.0 ?
+                                                       static_cast<float>(-10.0 * std::log10(meanSquaredError)) :
+                                                       std::numeric_limits<float>::infinity();
+    }
+    if(options.structuralSimilarity)
+    {
+        comparison.structuralSimilarity = structuralSimilarity(lhs, rhs, options.threadCount);
+    }
+    return comparison;
+}
+
+bool isWithinTolerance(const Image& lhs, const Image& rhs, float tolerance, unsigned int threadCount)
+{
+    if(lhs.width() != rhs.width() || lhs.height() != rhs.height())
+    {
+        return false;
+    }
+    // Set by the first chunk above the tolerance, the other chunks stop at their next block
+    std::atomic<bool> rejected{false};
+    const Color4f* lhsPixels = lhs.data();
+    const Color4f* rhsPixels = rhs.data();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(lhs.width()) * static_cast<std::size_t>(lhs.height()),
+      grainSize,
+      [&rejected, lhsPixels, rhsPixels, tolerance](std::size_t begin, std::size_t end) {
+          for(std::size_t block = begin; block < end && !rejected.load(std::memory_order_relaxed); block += blockSize)
+          {
+              const std::size_t count = std::min(blockSize, end - block);
+              if(!isRangeWithinTolerance(lhsPixels + block, rhsPixels + block, count, tolerance))
+              {
+                  rejected.store(true, std::memory_order_relaxed);
+              }
+          }
+      },
+      threadCount);
+    return !rejected.load();
+}
+
+} // namespace stbipp
@@ -0,0 +1,341 @@
+#include "stbipp/Compositing.hpp"
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+
+namespace
+{
+// Number of pixels processed by each task of the multithreaded operations
+constexpr std::size_t grainSize = 16384;
+
+using stbipp::CompositeOperator;
+
+/**
+ * @brief Composite a row of float colors, the switch on the operator template parameter is resolved at compile time
+ */
+template<CompositeOperator compositeOperator>
+void compositeRow(const stbipp::Color4f* source, stbipp::Color4f* destination, std::size_t count)
+{
+    using stbipp::Color4f;
+    const Color4f one(1.0f);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const Color4f& s = source[index];
+        Color4f& d = destination[index];
+        const Color4f sourceAlpha(s.a());
+        const Color4f destinationAlpha(d.a());
+        switch(compositeOperator)
+        {
+            case CompositeOperator::OVER: d = s + d * (one - sourceAlpha); break;
+            case CompositeOperator::IN: d = s * destinationAlpha; break;
+            case CompositeOperator::OUT: d = s * (one - destinationAlpha); break;
+            case CompositeOperator::ATOP: d = s * destinationAlpha + d * (one - sourceAlpha); break;
+            case CompositeOperator::XOR: d = s * (one - destinationAlpha) + d * (one - sourceAlpha); break;
+            case CompositeOperator::PLUS: d = s + d; break;
+            case CompositeOperator::MULTIPLY:
+                d = s * d + s * (one - destinationAlpha) + d * (one - sourceAlpha);
+                break;
+            case CompositeOperator::SCREEN: d = s + d - s * d; break;
+        }
+    }
+}
+
+/**
+ * @brief Multiply two values in [0, 255] and divide the result by 255, rounded to nearest
+ */
+inline unsigned int multiply255(unsigned int lhs, unsigned int rhs)
+{
+    const unsigned int product = lhs * rhs + 128;
+    return (product + (product >> 8)) >> 8;
+}
+
+template<CompositeOperator compositeOperator>
+unsigned int compositeValue(unsigned int s, unsigned int d, unsigned int sourceAlpha, unsigned int destinationAlpha)
+{
+    switch(compositeOperator)
+    {
+        case CompositeOperator::OVER: return s + multiply255(d, 255 - sourceAlpha);
+        case CompositeOperator::IN: return multiply255(s, destinationAlpha);
+        case CompositeOperator::OUT: return multiply255(s, 255 - destinationAlpha);
+        case CompositeOperator::ATOP: return multiply255(s, destinationAlpha) + multiply255(d, 255 - sourceAlpha);
+        case CompositeOperator::XOR:
+            return multiply255(s, 255 - destinationAlpha) + multiply255(d, 255 - sourceAlpha);
+        case CompositeOperator::PLUS: return s + d;
+        case CompositeOperator::MULTIPLY:
+            return multiply255(s, d) + multiply255(s, 255 - destinationAlpha) + multiply255(d, 255 - sourceAlpha);
+        case CompositeOperator::SCREEN: return s + d - multiply255(s, d);
+    }
+    return d;
+}
+
+#if defined(STBIPP_SIMD_SSE2)
+/**
+ * @brief multiply255 on eight 16 bits lanes
+ */
+inline __m128i multiply255(__m128i lhs, __m128i rhs)
+{
+    const __m128i product = _mm_add_epi16(_mm_mullo_epi16(lhs, rhs), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+/**
+ * @brief Copy the alpha of each of the two pixels stored in 16 bits lanes to its four lanes
+ */
+inline __m128i broadcastAlpha(__m128i pixels)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+}
+
+/**
+ * @brief Composite two pixels stored in 16 bits lanes, the results may exceed 255 and are saturated when packed
+ */
+template<CompositeOperator compositeOperator>
+__m128i compositePixels(__m128i s, __m128i d)
+{
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i sourceAlpha = broadcastAlpha(s);
+    const __m128i destinationAlpha = broadcastAlpha(d);
+    switch(compositeOperator)
+    {
+        case CompositeOperator::OVER: return _mm_add_epi16(s, multiply255(d, _mm_sub_epi16(full, sourceAlpha)));
+        case CompositeOperator::IN: return multiply255(s, destinationAlpha);
+        case CompositeOperator::OUT: return multiply255(s, _mm_sub_epi16(full, destinationAlpha));
+        case CompositeOperator::ATOP:
+            return _mm_add_epi16(multiply255(s, destinationAlpha), multiply255(d, _mm_sub_epi16(full, sourceAlpha)));
+        case CompositeOperator::XOR:
+            return _mm_add_epi16(multiply255(s, _mm_sub_epi16(full, destinationAlpha)),
+                                 multiply255(d, _mm_sub_epi16(full, sourceAlpha)));
+        case CompositeOperator::PLUS: return _mm_add_epi16(s, d);
+        case CompositeOperator::MULTIPLY:
+        {
+            const __m128i product = multiply255(s, d);
+            return _mm_add_epi16(_mm_add_epi16(product, multiply255(s, _mm_sub_epi16(full, destinationAlpha))),
+                                 multiply255(d, _mm_sub_epi16(full, sourceAlpha)));
+        }
+        case CompositeOperator::SCREEN: return _mm_sub_epi16(_mm_add_epi16(s, d), multiply255(s, d));
+    }
+    return d;
+}
+#endif
+
+/**
+ * @brief Composite a row of 8 bits colors, four pixels at a time with SSE2
+ */
+template<CompositeOperator compositeOperator>
+void compositeRow(const stbipp::Color4uc* source, stbipp::Color4uc* destination, std::size_t count)
+{
+    std::size_t index = 0;
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for(; index + 4 <= count; index += 4)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source[index].data()));
+        __m128i* output = reinterpret_cast<__m128i*>(destination[index].data());
+        const __m128i d = _mm_loadu_si128(output);
+        const __m128i low =
+          compositePixels<compositeOperator>(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+        const __m128i high =
+          compositePixels<compositeOperator>(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128(output, _mm_packus_epi16(low, high));
+    }
+#endif
+    for(; index < count; ++index)
+    {
+        const auto& s = source[index];
+        auto& d = destination[index];
+        const unsigned int sourceAlpha = s.a();
+        const unsigned int destinationAlpha = d.a();
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            const unsigned int value =
+              compositeValue<compositeOperator>(s[channel], d[channel], sourceAlpha, destinationAlpha);
+            d[channel] = static_cast<unsigned char>(std::min(value, 255u));
+        }
+    }
+}
+
+/**
+ * @brief Composite the clipped source region onto the destination, row bands are spread over several threads
+ */
+template<class ImageType, class ColorType>
+void compositeImages(const ImageType& source,
+                     ImageType& destination,
+                     CompositeOperator compositeOperator,
+                     const stbipp::CompositeOptions& options)
+{
+    using stbipp::Rect;
+    const Rect sourceBounds{0, 0, source.width(), source.height()};
+    const Rect requested = options.sourceRegion.isEmpty() ? sourceBounds : options.sourceRegion;
+    const Rect clipped = stbipp::intersect(requested, sourceBounds);
+    // Position of the clipped region in the destination, then clipped to the destination
+    const Rect placed{
+      options.x + clipped.x - requested.x, options.y + clipped.y - requested.y, clipped.width, clipped.height};
+    const Rect target = stbipp::intersect(placed, Rect{0, 0, destination.width(), destination.height()});
+    if(target.isEmpty())
+    {
+        return;
+    }
+    const int sourceX = clipped.x + target.x - placed.x;
+    const int sourceY = clipped.y + target.y - placed.y;
+
+    void (*rowFunction)(const ColorType*, ColorType*, std::size_t) = nullptr;
+    switch(compositeOperator)
+    {
+        case CompositeOperator::OVER: rowFunction = &compositeRow<CompositeOperator::OVER>; break;
+        case CompositeOperator::IN: rowFunction = &compositeRow<CompositeOperator::IN>; break;
+        case CompositeOperator::OUT: rowFunction = &compositeRow<CompositeOperator::OUT>; break;
+        case CompositeOperator::ATOP: rowFunction = &compositeRow<CompositeOperator::ATOP>; break;
+        case CompositeOperator::XOR: rowFunction = &compositeRow<CompositeOperator::XOR>; break;
+        case CompositeOperator::PLUS: rowFunction = &compositeRow<CompositeOperator::PLUS>; break;
+        case CompositeOperator::MULTIPLY: rowFunction = &compositeRow<CompositeOperator::MULTIPLY>; break;
+        case CompositeOperator::SCREEN: rowFunction = &compositeRow<CompositeOperator::SCREEN>; break;
+    }
+    if(rowFunction == nullptr)
+    {
+        return;
+    }
+
+    const auto sourceWidth = static_cast<std::size_t>(source.width());
+    const auto destinationWidth = static_cast<std::size_t>(destination.width());
+    const auto count = static_cast<std::size_t>(target.width);
+    const ColorType* input = source.data();
+    ColorType* output = destination.data();
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(target.height),
+      std::max<std::size_t>(1, grainSize / count),
+      [&](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              const ColorType* sourceRow = input + (static_cast<std::size_t>(sourceY) + row) * sourceWidth +
+                                           static_cast<std::size_t>(sourceX);
+              ColorType* destinationRow = output + (static_cast<std::size_t>(target.y) + row) * destinationWidth +
+                                          static_cast<std::size_t>(target.x);
+              rowFunction(sourceRow, destinationRow, count);
+          }
+      },
+      options.threadCount);
+}
+
+/**
+ * @brief Apply a function to chunks of the pixels of an image over several threads
+ */
+template<class ImageType, class Function>
+void forEachChunk(ImageType& image, unsigned int threadCount, Function function)
+{
+    auto* pixels = image.data();
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+      grainSize,
+      [pixels, &function](std::size_t begin, std::size_t end) { function(pixels + begin, end - begin); },
+      threadCount);
+}
+
+} // namespace
+
+namespace stbipp
+{
+void premultiplyAlpha(Color4f* colors, std::size_t count)
+{
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const float alpha = colors[index].a();
+        colors[index] *= Color4f(alpha, alpha, alpha, 1.0f);
+    }
+}
+
+void premultiplyAlpha(Color4uc* colors, std::size_t count)
+{
+    std::size_t index = 0;
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    // The alpha lanes are multiplied by 255 so they are kept
+    const __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaLanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const auto premultiply = [&](__m128i pixels) {
+        const __m128i factors = _mm_or_si128(_mm_and_si128(broadcastAlpha(pixels), colorLanes), alphaLanes);
+        return multiply255(pixels, factors);
+    };
+    for(; index + 4 <= count; index += 4)
+    {
+        __m128i* pixels = reinterpret_cast<__m128i*>(colors[index].data());
+        const __m128i values = _mm_loadu_si128(pixels);
+        const __m128i low = premultiply(_mm_unpacklo_epi8(values, zero));
+        const __m128i high = premultiply(_mm_unpackhi_epi8(values, zero));
+        _mm_storeu_si128(pixels, _mm_packus_epi16(low, high));
+    }
+#endif
+    for(; index < count; ++index)
+    {
+        auto& color = colors[index];
+        const unsigned int alpha = color.a();
+        for(unsigned int channel = 0; channel < 3; ++channel)
+        {
+            color[channel] = static_cast<unsigned char>(multiply255(color[channel], alpha));
+        }
+    }
+}
+
+void unpremultiplyAlpha(Color4f* colors, std::size_t count)
+{
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const float alpha = colors[index].a();
+        const float factor = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+        colors[index] *= Color4f(factor, factor, factor, 1.0f);
+    }
+}
+
+void unpremultiplyAlpha(Color4uc* colors, std::size_t count)
+{
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        auto& color = colors[index];
+        const unsigned int alpha = color.a();
+        for(unsigned int channel = 0; channel < 3; ++channel)
+        {
+            const unsigned int value = alpha == 0 ? 0 : (color[channel] * 255u + alpha / 2) / alpha;
+            color[channel] = static_cast<unsigned char>(std::min(value, 255u));
+        }
+    }
+}
+
+void premultiplyAlpha(Image& image, unsigned int threadCount)
+{
+    forEachChunk(image, threadCount, [](Color4f* colors, std::size_t count) { premultiplyAlpha(colors, count); });
+}
+
+void premultiplyAlpha(TypedImage<Color4uc>& image, unsigned int threadCount)
+{
+    forEachChunk(image, threadCount, [](Color4uc* colors, std::size_t count) { premultiplyAlpha(colors, count); });
+}
+
+void unpremultiplyAlpha(Image& image, unsigned int threadCount)
+{
+    forEachChunk(image, threadCount, [](Color4f* colors, std::size_t count) { unpremultiplyAlpha(colors, count); });
+}
+
+void unpremultiplyAlpha(TypedImage<Color4uc>& image, unsigned int threadCount)
+{
+    forEachChunk(image, threadCount, [](Color4uc* colors, std::size_t count) { unpremultiplyAlpha(colors, count); });
+}
+
+void composite(const Image& source,
+               Image& destination,
+               CompositeOperator compositeOperator,
+               const CompositeOptions& options)
+{
+    compositeImages<Image, Color4f>(source, destination, compositeOperator, options);
+}
+
+void composite(const TypedImage<Color4uc>& source,
+               TypedImage<Color4uc>& destination,
+               CompositeOperator compositeOperator,
+               const CompositeOptions& options)
+{
+    compositeImages<TypedImage<Color4uc>, Color4uc>(source, destination, compositeOperator, options);
+}
+
+} // namespace stbipp
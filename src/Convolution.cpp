@@ -0,0 +1,351 @@
+#include "stbipp/Convolution.hpp"
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+// Number of floats processed by each task of the multithreaded passes
+constexpr std::size_t grainSize = 65536;
+// Number of pixels of the column blocks of the vertical pass, the rows of a block stay in the cache
+constexpr std::size_t columnBlockSize = 256;
+
+std::size_t rowsPerTask(int width)
+{
+    return std::max<std::size_t>(1, grainSize / (static_cast<std::size_t>(std::max(width, 1)) * 4));
+}
+
+/**
+ * @brief Copy a row with radius pixels read with the border mode on each side
+ * @param[in] row The row to copy
+ * @param[in] width Number of pixels of the row
+ * @param[in] radius Number of pixels added on each side
+ * @param[in] options Border mode and color
+ * @param[out] padded The width + 2 * radius pixels
+ */
+void padRow(const stbipp::Color4f* row,
+            int width,
+            int radius,
+            const stbipp::ConvolutionOptions& options,
+            stbipp::Color4f* padded)
+{
+    stbipp::copyPixels(row, padded + radius, static_cast<std::size_t>(width));
+    for(int offset = 1; offset <= radius; ++offset)
+    {
+        const int left = stbipp::borderIndex(-offset, width, options.border);
+        const int right = stbipp::borderIndex(width - 1 + offset, width, options.border);
+        padded[radius - offset] = left < 0 ? options.borderColor : row[left];
+        padded[radius + width - 1 + offset] = right < 0 ? options.borderColor : row[right];
+    }
+}
+
+/**
+ * @brief Convolve a padded row with a kernel
+ */
+void convolveRow(const stbipp::Color4f* padded,
+                 const std::vector<float>& weights,
+                 stbipp::Color4f* destination,
+                 int width)
+{
+    const std::size_t size = weights.size();
+    for(int column = 0; column < width; ++column)
+    {
+        const stbipp::Color4f* source = padded + column;
+#if defined(STBIPP_SIMD_SSE2)
+        __m128 sum = _mm_setzero_ps();
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source[index].data()), _mm_set1_ps(weights[index])));
+        }
+        _mm_storeu_ps(destination[column].data(), sum);
+#else
+        float sum[4]{};
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            for(unsigned int channel = 0; channel < 4; ++channel)
+            {
+                sum[channel] += source[index][channel] * weights[index];
+            }
+        }
+        destination[column] = stbipp::Color4f(sum[0], sum[1], sum[2], sum[3]);
+#endif
+    }
+}
+
+/**
+ * @brief Add a row of colors multiplied by a weight to another row, or overwrite it
+ */
+void addWeightedRow(const stbipp::Color4f* source,
+                    float weight,
+                    stbipp::Color4f* destination,
+                    std::size_t count,
+                    bool overwrite)
+{
+    const float* input = source->data();
+    float* output = destination->data();
+    const std::size_t size = count * 4;
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 factor = _mm_set1_ps(weight);
+    for(std::size_t index = 0; index < size; index += 4)
+    {
+        const __m128 weighted = _mm_mul_ps(_mm_loadu_ps(input + index), factor);
+        _mm_storeu_ps(output + index, overwrite ? weighted : _mm_add_ps(_mm_loadu_ps(output + index), weighted));
+    }
+#else
+    for(std::size_t index = 0; index < size; ++index)
+    {
+        output[index] = (overwrite ? 0.0f : output[index]) + input[index] * weight;
+    }
+#endif
+}
+
+/**
+ * @brief Rows of an image read with a border mode
+ */
+class BorderRows
+{
+  public:
+    BorderRows(const stbipp::Image& image, const stbipp::ConvolutionOptions& options):
+      m_image(image),
+      m_options(options),
+      m_constantRow(options.border == stbipp::BorderMode::CONSTANT ? static_cast<std::size_t>(image.width()) : 0,
+                    options.borderColor)
+    {
+    }
+
+    const stbipp::Color4f* row(int index) const
+    {
+        const int row = stbipp::borderIndex(index, m_image.height(), m_options.border);
+        if(row < 0)
+        {
+            return m_constantRow.data();
+        }
+        return m_image.data() + static_cast<std::size_t>(row) * static_cast<std::size_t>(m_image.width());
+    }
+
+  private:
+    const stbipp::Image& m_image;
+    const stbipp::ConvolutionOptions& m_options;
+    std::vector<stbipp::Color4f> m_constantRow;
+};
+
+} // namespace
+
+namespace stbipp
+{
+Kernel1D::Kernel1D(std::vector<float> weights): m_weights(std::move(weights))
+{
+    if(m_weights.size() % 2 == 0)
+    {
+        throw std::invalid_argument("A kernel must have an odd number of weights");
+    }
+}
+
+Kernel1D Kernel1D::gaussian(float sigma, int radius)
+{
+    if(!(sigma > 0.0f) || radius < 0)
+    {
+        throw std::invalid_argument("Gaussian sigma must be positive and radius must not be negative");
+    }
+    if(radius == 0)
+    {
+        radius = static_cast<int>(std::ceil(3.0f * sigma));
+    }
+    std::vector<float> weights(static_cast<std::size_t>(2 * radius + 1));
+    double sum = 0.0;
+    for(int offset = -radius; offset <= radius; ++offset)
+    {
+        const double weight = std::exp(-static_cast<double>(offset * offset) / (2.0 * sigma * sigma));
+        weights[static_cast<std::size_t>(offset + radius)] = static_cast<float>(weight);
+        sum += weight;
+    }
+    for(auto& weight: weights)
+    {
+        weight = static_cast<float>(weight / sum);
+    }
+    return Kernel1D(std::move(weights));
+}
+
+Kernel1D Kernel1D::box(int radius)
+{
+    if(radius < 0)
+    {
+        throw std::invalid_argument("Box radius must not be negative");
+    }
+    const std::size_t size = static_cast<std::size_t>(2 * radius + 1);
+    return Kernel1D(std::vector<float>(size, 1.0f / static_cast<float>(size)));
+}
+
+int Kernel1D::radius() const
+{
+    return static_cast<int>(m_weights.size() / 2);
+}
+
+const std::vector<float>& Kernel1D::weights() const
+{
+    return m_weights;
+}
+
+Image convolveSeparable(const Image& image,
+                        const Kernel1D& horizontal,
+                        const Kernel1D& vertical,
+                        const ConvolutionOptions& options)
+{
+    const int width = image.width();
+    const int height = image.height();
+    const auto rowSize = static_cast<std::size_t>(width);
+    Image intermediate(width, height);
+    Image result(width, height);
+    if(width == 0 || height == 0)
+    {
+        return result;
+    }
+
+    const int horizontalRadius = horizontal.radius();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(height),
+      rowsPerTask(width),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<Color4f> padded(rowSize + 2 * static_cast<std::size_t>(horizontalRadius));
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              padRow(image.data() + row * rowSize, width, horizontalRadius, options, padded.data());
+              convolveRow(padded.data(), horizontal.weights(), intermediate.data() + row * rowSize, width);
+          }
+      },
+      options.threadCount);
+
+    const BorderRows rows(intermediate, options);
+    const int verticalRadius = vertical.radius();
+    const auto& weights = vertical.weights();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(height),
+      rowsPerTask(width),
+      [&](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              Color4f* destination = result.data() + row * rowSize;
+              for(std::size_t column = 0; column < rowSize; column += columnBlockSize)
+              {
+                  const std::size_t count = std::min(columnBlockSize, rowSize - column);
+                  for(std::size_t index = 0; index < weights.size(); ++index)
+                  {
+                      const int sourceRow = static_cast<int>(row) + static_cast<int>(index) - verticalRadius;
+                      const Color4f* source = rows.row(sourceRow) + column;
+                      addWeightedRow(source, weights[index], destination + column, count, index == 0);
+                  }
+              }
+          }
+      },
+      options.threadCount);
+    return result;
+}
+
+Image gaussianBlur(const Image& image, float sigma, const ConvolutionOptions& options)
+{
+    const Kernel1D kernel = Kernel1D::gaussian(sigma);
+    return convolveSeparable(image, kernel, kernel, options);
+}
+
+Image boxBlur(const Image& image, int radius, const ConvolutionOptions& options)
+{
+    if(radius < 0)
+    {
+        throw std::invalid_argument("Box radius must not be negative");
+    }
+    const int width = image.width();
+    const int height = image.height();
+    const auto rowSize = static_cast<std::size_t>(width);
+    const double scale = 1.0 / static_cast<double>(2 * radius + 1);
+    Image intermediate(width, height);
+    Image result(width, height);
+    if(width == 0 || height == 0)
+    {
+        return result;
+    }
+
+    // The sums are kept in doubles so sliding the window over long rows does not accumulate rounding errors
+    parallelFor(
+      0,
+      static_cast<std::size_t>(height),
+      rowsPerTask(width),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<Color4f> padded(rowSize + 2 * static_cast<std::size_t>(radius));
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              padRow(image.data() + row * rowSize, width, radius, options, padded.data());
+              Color4f* destination = intermediate.data() + row * rowSize;
+              double sum[4]{};
+              for(int index = 0; index < 2 * radius + 1; ++index)
+              {
+                  for(unsigned int channel = 0; channel < 4; ++channel)
+                  {
+                      sum[channel] += padded[static_cast<std::size_t>(index)][channel];
+                  }
+              }
+              for(std::size_t column = 0; column < rowSize; ++column)
+              {
+                  if(column > 0)
+                  {
+                      const Color4f& entering = padded[column + 2 * static_cast<std::size_t>(radius)];
+                      const Color4f& leaving = padded[column - 1];
+                      for(unsigned int channel = 0; channel < 4; ++channel)
+                      {
+                          sum[channel] += static_cast<double>(entering[channel]) - leaving[channel];
+                      }
+                  }
+                  for(unsigned int channel = 0; channel < 4; ++channel)
+                  {
+                      destination[column][channel] = static_cast<float>(sum[channel] * scale);
+                  }
+              }
+          }
+      },
+      options.threadCount);
+
+    // Each band of rows starts its own running sums of the columns
+    const BorderRows rows(intermediate, options);
+    parallelFor(
+      0,
+      static_cast<std::size_t>(height),
+      rowsPerTask(width),
+      [&](std::size_t begin, std::size_t end) {
+          const std::size_t valueCount = rowSize * 4;
+          std::vector<double> sums(valueCount, 0.0);
+          for(int offset = -radius; offset <= radius; ++offset)
+          {
+              const float* values = rows.row(static_cast<int>(begin) + offset)->data();
+              for(std::size_t index = 0; index < valueCount; ++index)
+              {
+                  sums[index] += values[index];
+              }
+          }
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              if(row > begin)
+              {
+                  const float* entering = rows.row(static_cast<int>(row) + radius)->data();
+                  const float* leaving = rows.row(static_cast<int>(row) - radius - 1)->data();
+                  for(std::size_t index = 0; index < valueCount; ++index)
+                  {
+                      sums[index] += static_cast<double>(entering[index]) - leaving[index];
+                  }
+              }
+              float* destination = (result.data() + row * rowSize)->data();
+              for(std::size_t index = 0; index < valueCount; ++index)
+              {
+                  destination[index] = static_cast<float>(sums[index] * scale);
+              }
+          }
+      },
+      options.threadCount);
+    return result;
+}
+
+} // namespace stbipp
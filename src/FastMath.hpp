@@ -0,0 +1,85 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+
+#include <cstdint>
+
+namespace stbipp
+{
+namespace detail
+{
+// The SSE2 approximations compute pow(x, p) as exp2(p * log2(x)), log2 with an atanh series and exp2 with a polynomial
+constexpr float log2Coefficient1 = 2.88539008f;   // 2 / ln(2)
+constexpr float log2Coefficient3 = 0.961796694f;  // 2 / (3 ln(2))
+constexpr float log2Coefficient5 = 0.577078016f;  // 2 / (5 ln(2))
+constexpr float log2Coefficient7 = 0.412198583f;  // 2 / (7 ln(2))
+constexpr float exp2Coefficient1 = 0.693147188f;  // Fitted on [-0.5, 0.5]
+constexpr float exp2Coefficient2 = 0.240223489f;
+constexpr float exp2Coefficient3 = 0.055503571f;
+constexpr float exp2Coefficient4 = 0.00966637369f;
+constexpr float exp2Coefficient5 = 0.00133908674f;
+// Bits of sqrt(0.5), the mantissa is reduced to [sqrt(0.5), sqrt(2)) to keep the series short
+constexpr std::int32_t reducedMantissaOffset = 0x3F3504F3;
+
+#if defined(STBIPP_SIMD_SSE2)
+/**
+ * @brief Approximate pow(values, exponent) for positive finite values, four at a time
+ */
+inline __m128 powApprox(__m128 values, float exponent)
+{
+    __m128i bits = _mm_castps_si128(values);
+    const __m128i log2Exponent = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(reducedMantissaOffset)), 23);
+    bits = _mm_sub_epi32(bits, _mm_slli_epi32(log2Exponent, 23));
+    const __m128 mantissa = _mm_castsi128_ps(bits);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 u = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+    const __m128 z = _mm_mul_ps(u, u);
+    __m128 series = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(log2Coefficient7), z), _mm_set1_ps(log2Coefficient5));
+    series = _mm_add_ps(_mm_mul_ps(series, z), _mm_set1_ps(log2Coefficient3));
+    series = _mm_add_ps(_mm_mul_ps(series, z), _mm_set1_ps(log2Coefficient1));
+    __m128 power =
+      _mm_mul_ps(_mm_set1_ps(exponent), _mm_add_ps(_mm_cvtepi32_ps(log2Exponent), _mm_mul_ps(u, series)));
+
+    power = _mm_min_ps(_mm_max_ps(power, _mm_set1_ps(-126.0f)), _mm_set1_ps(128.0f));
+    // Rounded to the nearest integer with the default rounding mode
+    const __m128i integral = _mm_cvtps_epi32(power);
+    const __m128 fraction = _mm_sub_ps(power, _mm_cvtepi32_ps(integral));
+    __m128 polynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(exp2Coefficient5), fraction), _mm_set1_ps(exp2Coefficient4));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(exp2Coefficient3));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(exp2Coefficient2));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(exp2Coefficient1));
+    const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integral, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(_mm_add_ps(one, _mm_mul_ps(fraction, polynomial)), scale);
+}
+
+/**
+ * @brief Pick the lanes of ifTrue where the mask is set and the lanes of ifFalse elsewhere
+ */
+inline __m128 select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+{
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+/**
+ * @brief Round values down to an integer, the values must be smaller than 2^31 in magnitude
+ */
+inline __m128 floorApprox(__m128 values)
+{
+    const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(values));
+    // Truncation rounds negative values up, one is removed from them
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, values), _mm_set1_ps(1.0f)));
+}
+
+/**
+ * @brief Mask of the lanes left unchanged by the conversions
+ */
+inline __m128 copiedChannelsMask(unsigned int colorChannels)
+{
+    const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+    return _mm_castsi128_ps(_mm_cmpgt_epi32(lanes, _mm_set1_epi32(static_cast<int>(colorChannels) - 1)));
+}
+#endif
+
+} // namespace detail
+} // namespace stbipp
@@ -1,7 +1,64 @@
 #include "stbipp/Image.hpp"
 
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
 #include <stdexcept>
 
+namespace
+{
+// Number of pixels converted or filled by each task of the multithreaded operations
+constexpr std::size_t grainSize = 16384;
+
+std::size_t pixelCount(int width, int height)
+{
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+}
+
+/**
+ * @brief Convert interleaved channels to colors
+ * @param[in] data The channels of each pixel, one after the other
+ * @param[in] count Number of pixels
+ * @param[in] channels Number of channels of each pixel
+ * @param[out] destination The converted colors
+ */
+template<class DataType>
+void convertInterleaved(const DataType* data, std::size_t count, int channels, stbipp::Color4f* destination)
+{
+    using stbipp::Color;
+    switch(channels)
+    {
+        case 1: convertPixels(reinterpret_cast<const Color<DataType, 1>*>(data), destination, count); break;
+        case 2: convertPixels(reinterpret_cast<const Color<DataType, 2>*>(data), destination, count); break;
+        case 3: convertPixels(reinterpret_cast<const Color<DataType, 3>*>(data), destination, count); break;
+        case 4: convertPixels(reinterpret_cast<const Color<DataType, 4>*>(data), destination, count); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Convert interleaved channels to colors, the pixels are split in chunks over several threads
+ */
+template<class DataType>
+void convertInterleaved(const DataType* data,
+                        std::size_t count,
+                        int channels,
+                        stbipp::Color4f* destination,
+                        unsigned int threadCount)
+{
+    stbipp::parallelFor(
+      0,
+      count,
+      grainSize,
+      [=](std::size_t begin, std::size_t end) {
+          const DataType* source = data + begin * static_cast<std::size_t>(channels);
+          convertInterleaved(source, end - begin, channels, destination + begin);
+      },
+      threadCount);
+}
+
+} // namespace
+
 namespace stbipp
 {
 Image::Image(int width, int height)
@@ -14,29 +71,27 @@ Image::Image(int width, int height, const Color& color): Image(width, height)
     fill(color);
 }
 
-Image::Image(const void* data, int width, int height, ImageFormat pixelFormat): Image(width, height)
+Image::Image(const void* data, int width, int height, ImageFormat pixelFormat, unsigned int threadCount):
+  Image(width, height)
 {
     if(isFormat8Bits(pixelFormat))
     {
         auto* ucdata = static_cast<const unsigned char*>(data);
-        copyData(ucdata, width, height, pixelFormat);
+        copyData(ucdata, width, height, pixelFormat, threadCount);
     }
     else if(isFormat16Bits(pixelFormat))
     {
         auto* usdata = static_cast<const unsigned short*>(data);
-        copyData(usdata, width, height, pixelFormat);
+        copyData(usdata, width, height, pixelFormat, threadCount);
     }
     else if(isFormat32Bits(pixelFormat))
     {
         auto* fdata = static_cast<const float*>(data);
-        copyData(fdata, width, height, pixelFormat);
+        copyData(fdata, width, height, pixelFormat, threadCount);
     }
 }
 
-Image::Image(const Image& other): Image(other.m_width, other.m_height)
-{
-    copyData(other);
-}
+Image::Image(const Image& other): m_data(other.m_data), m_width(other.m_width), m_height(other.m_height) {}
 
 Image::Image(Image&& other): m_width(other.width()), m_height(other.height())
 {
@@ -48,24 +103,36 @@ const Image::Color* Image::data() const
     return m_data.data();
 }
 
-void Image::fill(const Color& color)
+Image::Color* Image::data()
+{
+    return m_data.data();
+}
+
+void Image::fill(const Color& color, unsigned int threadCount)
 {
-    std::fill(begin(), end(), color);
+    Color* pixels = m_data.data();
+    parallelFor(
+      0,
+      m_data.size(),
+      grainSize,
+      [pixels, &color](std::size_t begin, std::size_t end) { fillPixels(pixels + begin, end - begin, color); },
+      threadCount);
 }
 
 void Image::resize(int width, int height)
 {
+    if(width < 0 || height < 0)
+    {
+        throw std::invalid_argument("New image dimensions must be positive integers!");
+    }
     std::vector<Color> newData(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
-    const auto minWidth = std::min(width, m_width);
+    const auto minWidth = static_cast<std::size_t>(std::min(width, m_width));
     const auto minHeight = std::min(height, m_height);
     for(int rowIndex = 0; rowIndex < minHeight; ++rowIndex)
     {
-        for(int columnIndex = 0; columnIndex < minWidth; ++columnIndex)
-        {
-            std::size_t index = static_cast<std::size_t>(rowIndex) * static_cast<std::size_t>(width) +
-                                static_cast<std::size_t>(columnIndex);
-            newData[index] = (*this)(columnIndex, rowIndex);
-        }
+        copyPixels(m_data.data() + static_cast<std::size_t>(rowIndex) * static_cast<std::size_t>(m_width),
+                   newData.data() + static_cast<std::size_t>(rowIndex) * static_cast<std::size_t>(width),
+                   minWidth);
     }
     std::swap(m_data, newData);
     m_width = width;
@@ -106,7 +173,7 @@ Image& Image::operator=(const Image& other)
     {
         m_width = other.width();
         m_height = other.height();
-        std::vector<Color> newData(m_width * m_height);
+        std::vector<Color> newData(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
         std::swap(m_data, newData);
     }
     copyData(other);
@@ -115,61 +182,34 @@ Image& Image::operator=(const Image& other)
 
 void Image::copyData(const Image& other)
 {
-    std::copy(other.cbegin(), other.cend(), begin());
+    copyPixels(other.m_data.data(), m_data.data(), other.m_data.size());
 }
 
-void Image::copyData(const unsigned char* data, int width, int height, ImageFormat pixelFormat)
+void Image::copyData(const unsigned char* data,
+                     int width,
+                     int height,
+                     ImageFormat pixelFormat,
+                     unsigned int threadCount)
 {
-    for(int rowIndex = 0; rowIndex < height; ++rowIndex)
-    {
-        for(int columnIndex = 0; columnIndex < width; ++columnIndex)
-        {
-            Color4uc color{};
-            auto channels = formatChannelCount(pixelFormat);
-            for(int colorComponent = 0; colorComponent < channels; ++colorComponent)
-            {
-                color[colorComponent] =
-                  *(data + ((width * channels * rowIndex) + columnIndex * channels + colorComponent));
-            }
-            (*this)(columnIndex, rowIndex) = color;
-        }
-    }
+    convertInterleaved(data, pixelCount(width, height), formatChannelCount(pixelFormat), m_data.data(), threadCount);
 }
 
-void Image::copyData(const unsigned short* data, int width, int height, ImageFormat pixelFormat)
+void Image::copyData(const unsigned short* data,
+                     int width,
+                     int height,
+                     ImageFormat pixelFormat,
+                     unsigned int threadCount)
 {
-    for(int rowIndex = 0; rowIndex < height; ++rowIndex)
-    {
-        for(int columnIndex = 0; columnIndex < width; ++columnIndex)
-        {
-            Color4us color{};
-            auto channels = formatChannelCount(pixelFormat);
-            for(int colorComponent = 0; colorComponent < channels; ++colorComponent)
-            {
-                color[colorComponent] =
-                  *(data + ((width * channels * rowIndex) + columnIndex * channels + colorComponent));
-            }
-            (*this)(columnIndex, rowIndex) = color;
-        }
-    }
+    convertInterleaved(data, pixelCount(width, height), formatChannelCount(pixelFormat), m_data.data(), threadCount);
 }
 
-void Image::copyData(const float* data, int width, int height, ImageFormat pixelFormat)
+void Image::copyData(const float* data,
+                     int width,
+                     int height,
+                     ImageFormat pixelFormat,
+                     unsigned int threadCount)
 {
-    for(int rowIndex = 0; rowIndex < height; ++rowIndex)
-    {
-        for(int columnIndex = 0; columnIndex < width; ++columnIndex)
-        {
-            Color4f color{};
-            auto channels = formatChannelCount(pixelFormat);
-            for(int colorComponent = 0; colorComponent < channels; ++colorComponent)
-            {
-                color[colorComponent] =
-                  *(data + ((width * channels * rowIndex) + columnIndex * channels + colorComponent));
-            }
-            (*this)(columnIndex, rowIndex) = color;
-        }
-    }
+    convertInterleaved(data, pixelCount(width, height), formatChannelCount(pixelFormat), m_data.data(), threadCount);
 }
 
 void Image::resizeData(int width, int height)
@@ -0,0 +1,256 @@
+#include "stbipp/ImageCodec.hpp"
+
+#include "BuiltinCodecs.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace
+{
+stbipp::CodecCapabilities makeCapabilities(const std::vector<int>& bitDepths, const std::vector<int>& channelCounts)
+{
+    stbipp::CodecCapabilities capabilities;
+    capabilities.bitDepths = bitDepths;
+    capabilities.channelCounts = channelCounts;
+    return capabilities;
+}
+
+stbipp::ImageCodec makeStbCodec(const std::string& name,
+                                stbipp::ImageFileFormat format,
+                                const std::vector<std::string>& extensions,
+                                const std::vector<std::string>& signatures,
+                                const std::vector<int>& decodedBitDepths,
+                                const std::vector<int>& decodedChannelCounts)
+{
+    stbipp::ImageCodec codec;
+    codec.name = name;
+    codec.format = format;
+    codec.extensions = extensions;
+    codec.signatures = signatures;
+    codec.decoding = makeCapabilities(decodedBitDepths, decodedChannelCounts);
+    codec.decode = stbipp::decodeStbImage;
+    return codec;
+}
+
+std::vector<stbipp::ImageCodec> builtinCodecs()
+{
+    using stbipp::ImageFileFormat;
+
+    const std::vector<int> allChannelCounts{1, 2, 3, 4};
+    std::vector<stbipp::ImageCodec> codecs;
+
+    codecs.push_back(
+      makeStbCodec("JPEG", ImageFileFormat::JPEG, {"jpg", "jpeg", "jpe"}, {"\xFF\xD8\xFF"}, {8}, {1, 3}));
+    codecs.back().encoding = makeCapabilities({8}, allChannelCounts);
+    codecs.back().encode = stbipp::encodeJpgImage;
+
+    codecs.push_back(makeStbCodec(
+      "PNG", ImageFileFormat::PNG, {"png"}, {"\x89PNG\r\n\x1A\n"}, {8, 16}, allChannelCounts));
+    codecs.back().encoding = makeCapabilities({8}, allChannelCounts);
+    codecs.back().encode = stbipp::encodePngImage;
+
+    codecs.push_back(makeStbCodec("BMP", ImageFileFormat::BMP, {"bmp", "dib"}, {"BM"}, {8}, {3, 4}));
+    codecs.back().encoding = makeCapabilities({8}, allChannelCounts);
+    codecs.back().encode = stbipp::encodeBmpImage;
+
+    // TGA files have no signature, they are only recognized by their extension
+    codecs.push_back(makeStbCodec("TGA", ImageFileFormat::TGA, {"tga"}, {}, {8}, allChannelCounts));
+    codecs.back().encoding = makeCapabilities({8}, allChannelCounts);
+    codecs.back().encode = stbipp::encodeTgaImage;
+
+    codecs.push_back(makeStbCodec("PSD", ImageFileFormat::PSD, {"psd"}, {"8BPS"}, {8, 16}, allChannelCounts));
+
+    codecs.push_back(makeStbCodec("GIF", ImageFileFormat::GIF, {"gif"}, {"GIF87a", "GIF89a"}, {8}, {4}));
+
+    codecs.push_back(
+      makeStbCodec("HDR", ImageFileFormat::HDR, {"hdr", "rgbe"}, {"#?RADIANCE\n", "#?RGBE\n"}, {32}, {3}));
+    codecs.back().encoding = makeCapabilities({32}, allChannelCounts);
+    codecs.back().encode = stbipp::encodeHdrImage;
+
+    codecs.push_back(
+      makeStbCodec("PIC", ImageFileFormat::PIC, {"pic"}, {std::string("\x53\x80\xF6\x34", 4)}, {8}, {3, 4}));
+
+    codecs.push_back(makeStbCodec("PNM", ImageFileFormat::PNM, {"pnm", "ppm", "pgm"}, {"P5", "P6"}, {8, 16}, {1, 3}));
+
+    stbipp::ImageCodec qoi;
+    qoi.name = "QOI";
+    qoi.format = ImageFileFormat::QOI;
+    qoi.extensions = {"qoi"};
+    qoi.signatures = {"qoif"};
+    qoi.decoding = makeCapabilities({8}, {3, 4});
+    qoi.decoding.streaming = true;
+    qoi.encoding = qoi.decoding;
+    qoi.decode = stbipp::decodeQoiImage;
+    qoi.encode = stbipp::encodeQoiImage;
+    codecs.push_back(qoi);
+
+    stbipp::ImageCodec raw;
+    raw.name = "RAW";
+    raw.format = ImageFileFormat::RAW;
+    raw.extensions = {"sraw"};
+    raw.signatures = {"STBIPRAW"};
+    raw.decoding = makeCapabilities({8, 16, 32}, allChannelCounts);
+    raw.encoding = makeCapabilities({32}, allChannelCounts);
+    raw.decode = stbipp::decodeRawImage;
+    raw.encode = stbipp::encodeRawImage;
+    codecs.push_back(raw);
+
+    return codecs;
+}
+
+} // namespace
+
+namespace stbipp
+{
+std::string fileExtension(const std::string& path)
+{
+    const auto dotPosition = path.find_last_of('.');
+    const auto separatorPosition = path.find_last_of("/\\");
+    if(dotPosition == std::string::npos ||
+       (separatorPosition != std::string::npos && separatorPosition > dotPosition))
+    {
+        return {};
+    }
+    std::string extension = path.substr(dotPosition + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return extension;
+}
+
+CodecRegistry& CodecRegistry::instance()
+{
+    static CodecRegistry registry;
+    return registry;
+}
+
+CodecRegistry::CodecRegistry()
+{
+    for(const auto& codec: builtinCodecs())
+    {
+        m_codecs.push_back(std::make_shared<const ImageCodec>(codec));
+    }
+    rebuildIndex();
+}
+
+void CodecRegistry::registerCodec(const ImageCodec& codec)
+{
+    auto codecPtr = std::make_shared<const ImageCodec>(codec);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = std::find_if(m_codecs.begin(), m_codecs.end(), [&codec](const CodecPtr& registered) {
+        return registered->name == codec.name;
+    });
+    if(it != m_codecs.end())
+    {
+        m_codecs.erase(it);
+    }
+    m_codecs.push_back(std::move(codecPtr));
+    rebuildIndex();
+}
+
+std::vector<CodecRegistry::CodecPtr> CodecRegistry::codecs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_codecs;
+}
+
+CodecRegistry::CodecPtr CodecRegistry::find(ImageFileFormat format) const
+{
+    if(format == ImageFileFormat::CUSTOM)
+    {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = std::find_if(m_codecs.rbegin(), m_codecs.rend(), [format](const CodecPtr& codec) {
+        return codec->format == format;
+    });
+    return it != m_codecs.rend() ? *it : nullptr;
+}
+
+CodecRegistry::CodecPtr CodecRegistry::findByName(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it =
+      std::find_if(m_codecs.begin(), m_codecs.end(), [&name](const CodecPtr& codec) { return codec->name == name; });
+    return it != m_codecs.end() ? *it : nullptr;
+}
+
+CodecRegistry::CodecPtr CodecRegistry::findByExtension(const std::string& extension) const
+{
+    std::string key(extension);
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_extensions.find(key);
+    return it != m_extensions.end() ? it->second : nullptr;
+}
+
+CodecRegistry::CodecPtr CodecRegistry::findBySignature(const unsigned char* data, std::size_t size) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(const auto& signature: m_signatures)
+    {
+        if(signature.first.size() <= size &&
+           std::equal(signature.first.begin(), signature.first.end(), data, [](char lhs, unsigned char rhs) {
+               return static_cast<unsigned char>(lhs) == rhs;
+           }))
+        {
+            return signature.second;
+        }
+    }
+    return nullptr;
+}
+
+CodecRegistry::CodecPtr CodecRegistry::findForFile(const std::string& path) const
+{
+    std::size_t signatureSize;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        signatureSize = m_maxSignatureSize;
+    }
+    std::vector<unsigned char> header(signatureSize);
+    std::ifstream file(path, std::ios::binary);
+    if(file && signatureSize > 0)
+    {
+        file.read(reinterpret_cast<char*>(header.data()), static_cast<std::streamsize>(signatureSize));
+        const auto codec = findBySignature(header.data(), static_cast<std::size_t>(file.gcount()));
+        if(codec)
+        {
+            return codec;
+        }
+    }
+    return findByExtension(fileExtension(path));
+}
+
+void CodecRegistry::rebuildIndex()
+{
+    m_extensions.clear();
+    m_signatures.clear();
+    m_maxSignatureSize = 0;
+    for(const auto& codec: m_codecs)
+    {
+        for(const auto& extension: codec->extensions)
+        {
+            m_extensions[extension] = codec;
+        }
+    }
+    // Latest codecs first so they take precedence, then longest signatures first so a signature that is the prefix
+    // of another one does not hide it
+    for(auto it = m_codecs.rbegin(); it != m_codecs.rend(); ++it)
+    {
+        for(const auto& signature: (*it)->signatures)
+        {
+            m_signatures.emplace_back(signature, *it);
+            m_maxSignatureSize = std::max(m_maxSignatureSize, signature.size());
+        }
+    }
+    std::stable_sort(m_signatures.begin(),
+                     m_signatures.end(),
+                     [](const std::pair<std::string, CodecPtr>& lhs, const std::pair<std::string, CodecPtr>& rhs) {
+                         return lhs.first.size() > rhs.first.size();
+                     });
+}
+
+} // namespace stbipp
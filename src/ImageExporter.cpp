@@ -2,23 +2,34 @@
 
 #include "stbipp/ImageExporter.hpp"
 
+#include "BuiltinCodecs.hpp"
+#include "PngEncoder.hpp"
+#include "stbipp/ImageCodec.hpp"
+#include "stbipp/Parallel.hpp"
+#include "stbipp/Srgb.hpp"
+#include "stbipp/ToneMapping.hpp"
+
 #include <algorithm>
-#include <cctype>
 #include <functional>
+#include <mutex>
 #include <stb_image_write.h>
-#include <unordered_set>
 
 namespace
 {
-using SaveFunction = std::function<bool(char const*, int, int, int, const void*)>;
+// Number of pixels converted by each task of the multithreaded conversions
+constexpr std::size_t grainSize = 16384;
 
-const std::unordered_set<std::string> getOneByteFileSavedFormat();
-const std::unordered_set<std::string> getSupportedSaveFileFormat();
+using SaveFunction = std::function<bool(char const*, int, int, int, const void*)>;
 
 // 8
-bool write_png(char const* filename, int w, int h, int comp, const void* data)
+bool write_png(char const* filename,
+               int w,
+               int h,
+               int comp,
+               const void* data,
+               const stbipp::PngEncoderSettings& settings)
 {
-    return stbi_write_png(filename, w, h, comp, data, w * comp);
+    return stbipp::writePng(filename, w, h, comp, static_cast<const unsigned char*>(data), settings);
 }
 // 8
 bool write_bmp(char const* filename, int w, int h, int comp, const void* data)
@@ -26,8 +37,12 @@ bool write_bmp(char const* filename, int w, int h, int comp, const void* data)
     return stbi_write_bmp(filename, w, h, comp, data);
 }
 // 8
-bool write_tga(char const* filename, int w, int h, int comp, const void* data)
+bool write_tga(char const* filename, int w, int h, int comp, const void* data, bool rle)
 {
+    // stb_image_write only exposes the RLE switch as a global, concurrent TGA saves must not interleave
+    static std::mutex tgaMutex;
+    std::lock_guard<std::mutex> lock(tgaMutex);
+    stbi_write_tga_with_rle = rle ? 1 : 0;
     return stbi_write_tga(filename, w, h, comp, data);
 }
 // 32
@@ -36,146 +51,238 @@ bool write_hdr(char const* filename, int w, int h, int comp, const void* data)
     return stbi_write_hdr(filename, w, h, comp, static_cast<const float*>(data));
 }
 
-bool write_jpg(char const* filename, int w, int h, int comp, const void* data)
+bool write_jpg(char const* filename, int w, int h, int comp, const void* data, int quality)
 {
-    return stbi_write_jpg(filename, w, h, comp, data, 100);
+    return stbi_write_jpg(filename, w, h, comp, data, std::min(std::max(quality, 1), 100));
 }
 
-bool isOneByteFileSavedFormat(const std::string& extension)
+/**
+ * @brief Cast the image data to another color type, values are clamped to [0, 1] for integer color types
+ * The tone mapping and the sRGB encoding are applied to each row in a small buffer right before the cast, so no
+ * intermediate copy of the image is made.
+ * @param[in] image The image to cast
+ * @param[in] options Row order, tone mapping, sRGB encoding and thread count
+ * @param[in] encodeColors Apply the tone mapping and the sRGB encoding of the options, for 8 bits formats
+ * @return The pixel matrix casted
+ */
+template<class ColorType>
+std::vector<ColorType> castImage(const stbipp::Image& image, const stbipp::SaveOptions& options, bool encodeColors)
 {
-    return getOneByteFileSavedFormat().count(extension);
-}
-
-bool isFileSavedFormatSupported(const std::string& extension)
-{
-    return getSupportedSaveFileFormat().count(extension);
+    const bool applyToneMapping = encodeColors && !options.toneMapping.isClampOnly();
+    const bool encodeSrgb = encodeColors && options.linearToSrgb;
+    if(!options.flipVertically && !applyToneMapping && !encodeSrgb)
+    {
+        return image.castData<ColorType>(options.threadCount);
+    }
+    const auto width = static_cast<std::size_t>(image.width());
+    // Gray images only have their first channel encoded, the second one is the alpha
+    const unsigned int colorChannels = ColorType{}.size() >= 3 ? 3 : 1;
+    std::vector<ColorType> castedValue(width * static_cast<std::size_t>(image.height()));
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(image.height()),
+      std::max<std::size_t>(1, grainSize / std::max<std::size_t>(width, 1)),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<stbipp::Color4f> encodedRow(applyToneMapping || encodeSrgb ? width : 0);
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              const auto sourceRow = options.flipVertically ? static_cast<std::size_t>(image.height()) - 1 - row : row;
+              const stbipp::Color4f* source = image.data() + width * sourceRow;
+              if(applyToneMapping)
+              {
+                  stbipp::toneMap(source, encodedRow.data(), width, options.toneMapping, colorChannels);
+                  source = encodedRow.data();
+              }
+              if(encodeSrgb)
+              {
+                  stbipp::linearToSrgb(source, encodedRow.data(), width, colorChannels);
+                  source = encodedRow.data();
+              }
+              stbipp::convertPixels(source, castedValue.data() + width * row, width);
+          }
+      },
+      options.threadCount);
+    return castedValue;
 }
 
-const std::unordered_set<std::string> getOneByteFileSavedFormat()
+/**
+ * @brief Convert the rows of a half image to interleaved floats
+ * @param[in] image The image to convert
+ * @param[in] flipVertically Store the rows from bottom to top
+ * @return The channels of each pixel
+ */
+template<unsigned int channels>
+std::vector<float> halfImageToFloats(const stbipp::HalfImage& image, bool flipVertically)
 {
-    return {"png", "bmp", "tga", "jpg", "jpeg"};
+    using FloatColor = stbipp::Color<float, channels>;
+    const auto width = static_cast<std::size_t>(image.width());
+    std::vector<float> values(width * static_cast<std::size_t>(image.height()) * channels);
+    std::vector<stbipp::Color4f> row(width);
+    for(int y = 0; y < image.height(); ++y)
+    {
+        const auto sourceRow = static_cast<std::size_t>(flipVertically ? image.height() - 1 - y : y);
+        stbipp::convertPixels(image.data() + width * sourceRow, row.data(), width);
+        auto* destination = reinterpret_cast<FloatColor*>(values.data()) + width * static_cast<std::size_t>(y);
+        stbipp::convertPixels(row.data(), destination, width);
+    }
+    return values;
 }
 
-const std::unordered_set<std::string> getSupportedSaveFileFormat()
+bool saveOneByteImage(const SaveFunction& function,
+                      const std::string& path,
+                      const stbipp::Image& image,
+                      const stbipp::ImageSaveFormat pixelFormat,
+                      const stbipp::SaveOptions& options)
 {
-    auto fileFormat = getOneByteFileSavedFormat();
-    fileFormat.insert({"hdr"});
-    return fileFormat;
-}
+    using namespace stbipp;
 
-void cropColorValues(stbipp::Image& image)
-{
-    for(int y = 0; y < image.height(); ++y)
+    const int channels = formatChannelCount(pixelFormat);
+    if(pixelFormat == ImageSaveFormat::LUM)
+    {
+        const auto dataVector = castImage<Coloruc>(image, options, true);
+        return function(path.data(), image.width(), image.height(), channels, dataVector.data());
+    }
+    else if(pixelFormat == ImageSaveFormat::LUMA)
+    {
+        const auto dataVector = castImage<Color2uc>(image, options, true);
+        return function(path.data(), image.width(), image.height(), channels, dataVector.data());
+    }
+    else if(pixelFormat == ImageSaveFormat::RGB)
     {
-        for(int x = 0; x < image.width(); ++x)
-        {
-            for(auto& value: image(x, y))
-            {
-                if(value > 1.0)
-                    value = 1.0;
-            }
-        }
+        const auto dataVector = castImage<Color3uc>(image, options, true);
+        return function(path.data(), image.width(), image.height(), channels, dataVector.data());
     }
+    else if(pixelFormat == ImageSaveFormat::RGBA)
+    {
+        const auto dataVector = castImage<Color4uc>(image, options, true);
+        return function(path.data(), image.width(), image.height(), channels, dataVector.data());
+    }
+    return false;
 }
 
 } // namespace
 
 namespace stbipp
 {
-bool saveImage(const std::string& path, const Image& image, const ImageSaveFormat pixelFormat)
+bool encodePngImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
 {
-    std::string pathExtension = path.substr(path.find_last_of(".") + 1);
+    const auto function = [&options](char const* filename, int w, int h, int comp, const void* data) {
+        return write_png(filename, w, h, comp, data, options.png);
+    };
+    return saveOneByteImage(function, path, image, pixelFormat, options);
+}
 
-    if(pathExtension.empty())
-    {
-        return false;
-    }
+bool encodeBmpImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
+    return saveOneByteImage(write_bmp, path, image, pixelFormat, options);
+}
 
-    std::transform(pathExtension.begin(), pathExtension.end(), pathExtension.begin(), [](unsigned char c) {
-        return std::tolower(c);
-    });
+bool encodeTgaImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
+    const auto function = [&options](char const* filename, int w, int h, int comp, const void* data) {
+        return write_tga(filename, w, h, comp, data, options.tgaRle);
+    };
+    return saveOneByteImage(function, path, image, pixelFormat, options);
+}
 
-    if(!isFileSavedFormatSupported(pathExtension))
-    {
-        return false;
-    }
+bool encodeJpgImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
+    const auto function = [&options](char const* filename, int w, int h, int comp, const void* data) {
+        return write_jpg(filename, w, h, comp, data, options.jpegQuality);
+    };
+    return saveOneByteImage(function, path, image, pixelFormat, options);
+}
 
+bool encodeHdrImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
     const int channels = formatChannelCount(pixelFormat);
-
-    ::SaveFunction function;
-
-    if(pathExtension == "png")
+    if(pixelFormat == ImageSaveFormat::LUM)
     {
-        function = write_png;
+        auto dataVector = castImage<Colorf>(image, options, false);
+        return write_hdr(path.data(), image.width(), image.height(), channels, dataVector.data());
     }
-    else if(pathExtension == "bmp")
+    else if(pixelFormat == ImageSaveFormat::LUMA)
     {
-        function = write_bmp;
+        auto dataVector = castImage<Color2f>(image, options, false);
+        return write_hdr(path.data(), image.width(), image.height(), channels, dataVector.data());
     }
-    else if(pathExtension == "tga")
+    else if(pixelFormat == ImageSaveFormat::RGB)
     {
-        function = write_tga;
+        auto dataVector = castImage<Color3f>(image, options, false);
+        return write_hdr(path.data(), image.width(), image.height(), channels, dataVector.data());
     }
-    else if(pathExtension == "jpg" || pathExtension == "jpeg")
+    else if(pixelFormat == ImageSaveFormat::RGBA)
     {
-        function = write_jpg;
+        auto dataVector = castImage<Color4f>(image, options, false);
+        return write_hdr(path.data(), image.width(), image.height(), channels, dataVector.data());
     }
+    return false;
+}
 
-    else if(pathExtension == "hdr")
+bool saveImage(const std::string& path,
+               const Image& image,
+               const ImageSaveFormat pixelFormat,
+               const SaveOptions& options)
+{
+    const auto codec = CodecRegistry::instance().findByExtension(fileExtension(path));
+    if(!codec || !codec->encode)
     {
-        function = write_hdr;
+        return false;
     }
+    return codec->encode(path, image, pixelFormat, options);
+}
 
-    if(isOneByteFileSavedFormat(pathExtension))
+bool saveImage(const std::string& path,
+               const HalfImage& image,
+               const ImageSaveFormat pixelFormat,
+               const SaveOptions& options)
+{
+    const auto codec = CodecRegistry::instance().findByExtension(fileExtension(path));
+    if(!codec || codec->format != ImageFileFormat::HDR)
     {
-        Image croppedImage(image);
-        cropColorValues(croppedImage);
-        if(pixelFormat == ImageSaveFormat::LUM)
-        {
-            const auto dataVector = croppedImage.castData<Coloruc>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::LUMA)
-        {
-            const auto dataVector = croppedImage.castData<Color2uc>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::RGB)
-        {
-            const auto dataVector = croppedImage.castData<Color3uc>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::RGBA)
-        {
-            const auto dataVector = croppedImage.castData<Color4uc>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
+        return saveImage(path, image.toImage(), pixelFormat, options);
     }
 
-    else
+    const int channels = formatChannelCount(pixelFormat);
+    std::vector<float> values;
+    switch(pixelFormat)
     {
-        if(pixelFormat == ImageSaveFormat::LUM)
-        {
-            auto dataVector = image.castData<Colorf>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::LUMA)
-        {
-            auto dataVector = image.castData<Color2f>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::RGB)
-        {
-            auto dataVector = image.castData<Color3f>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
-        else if(pixelFormat == ImageSaveFormat::RGBA)
-        {
-            auto dataVector = image.castData<Color4f>();
-            return function(path.data(), image.width(), image.height(), channels, dataVector.data());
-        }
+        case ImageSaveFormat::LUM: values = halfImageToFloats<1>(image, options.flipVertically); break;
+        case ImageSaveFormat::LUMA: values = halfImageToFloats<2>(image, options.flipVertically); break;
+        case ImageSaveFormat::RGB: values = halfImageToFloats<3>(image, options.flipVertically); break;
+        case ImageSaveFormat::RGBA: values = halfImageToFloats<4>(image, options.flipVertically); break;
+        default: return false;
     }
-    return false;
+    return write_hdr(path.data(), image.width(), image.height(), channels, values.data());
+}
+
+bool savePng(const std::string& path,
+             const Image& image,
+             const ImageSaveFormat pixelFormat,
+             const PngEncoderSettings& settings)
+{
+    const auto function = [&settings](char const* filename, int w, int h, int comp, const void* data) {
+        return write_png(filename, w, h, comp, data, settings);
+    };
+    SaveOptions options;
+    options.png = settings;
+    options.threadCount = settings.threadCount;
+    return saveOneByteImage(function, path, image, pixelFormat, options);
 }
 
 int formatChannelCount(const ImageSaveFormat& format)
@@ -2,12 +2,20 @@
 
 #include "stbipp/ImageImporter.hpp"
 
+#include "BuiltinCodecs.hpp"
+#include "stbipp/ImageCodec.hpp"
+#include "stbipp/Parallel.hpp"
+#include "stbipp/Srgb.hpp"
+
 #include <exception>
 #include <iostream>
 #include <stb_image.h>
 #include <string>
 namespace
 {
+// Number of pixels converted by each task of the multithreaded conversions
+constexpr std::size_t grainSize = 16384;
+
 int deduceSTBIType(const stbipp::ImageFormat& format)
 {
     using stbipp::ImageFormat;
@@ -62,12 +70,23 @@ void freeStbData(void* data)
     }
 }
 
-} // namespace
-
-namespace stbipp
+bool decodesWithStb(const stbipp::ImageCodec& codec)
 {
-bool loadImage(const std::string& path, Image& image, const ImageFormat pixelFormat)
+    using DecodeFunction = bool (*)(const std::string&, stbipp::Image&, const stbipp::ImageFormat);
+    const auto* function = codec.decode.target<DecodeFunction>();
+    return function != nullptr && *function == &stbipp::decodeStbImage;
+}
+
+/**
+ * @brief Decode a file with stb_image, the pixels are converted over several threads
+ */
+bool decodeStb(const std::string& path,
+               stbipp::Image& image,
+               const stbipp::ImageFormat pixelFormat,
+               unsigned int threadCount)
 {
+    using namespace stbipp;
+
     int width{};
     int height{};
     void* data{nullptr};
@@ -85,11 +104,138 @@ bool loadImage(const std::string& path, Image& image, const ImageFormat pixelFor
     }
     if(data != nullptr)
     {
-        image = Image(data, static_cast<unsigned int>(width), static_cast<unsigned int>(height), pixelFormat);
+        image = Image(data, width, height, pixelFormat, threadCount);
         freeStbData(data);
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Convert sRGB interleaved channels to linear colors, the pixels are split in chunks over several threads
+ */
+template<class DataType>
+void convertSrgb(const DataType* data, int channels, stbipp::Image& image, unsigned int threadCount)
+{
+    stbipp::Color4f* destination = image.data();
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+      grainSize,
+      [=](std::size_t begin, std::size_t end) {
+          stbipp::srgbToLinear(
+            data + begin * static_cast<std::size_t>(channels), channels, destination + begin, end - begin);
+      },
+      threadCount);
+}
+
+/**
+ * @brief Decode a file with stb_image and convert its sRGB values to linear ones with the lookup tables
+ */
+bool decodeStbSrgbImage(const std::string& path,
+                        stbipp::Image& image,
+                        const stbipp::ImageFormat pixelFormat,
+                        unsigned int threadCount)
+{
+    using namespace stbipp;
+
+    if(stbi_is_hdr(path.data()))
+    {
+        return decodeStb(path, image, pixelFormat, threadCount);
+    }
+    int width{};
+    int height{};
+    const int channels = formatChannelCount(pixelFormat);
+    if(isFormat8Bits(pixelFormat))
+    {
+        unsigned char* data = loadUCharImage(path, width, height, pixelFormat);
+        if(data == nullptr)
+        {
+            return false;
+        }
+        image = Image(width, height);
+        convertSrgb(data, channels, image, threadCount);
+        freeStbData(data);
+        return true;
+    }
+    unsigned short* data = loadUShortImage(path, width, height, pixelFormat);
+    if(data == nullptr)
+    {
+        return false;
+    }
+    image = Image(width, height);
+    convertSrgb(data, channels, image, threadCount);
+    freeStbData(data);
+    return true;
+}
+
+} // namespace
+
+namespace stbipp
+{
+bool decodeStbImage(const std::string& path, Image& image, const ImageFormat pixelFormat)
+{
+    return decodeStb(path, image, pixelFormat, 1);
+}
+
+bool loadImage(const std::string& path, Image& image, const ImageFormat pixelFormat, const LoadOptions& options)
+{
+    const auto codec = CodecRegistry::instance().findForFile(path);
+    if(codec && codec->decode && !decodesWithStb(*codec))
+    {
+        if(!codec->decode(path, image, pixelFormat))
+        {
+            return false;
+        }
+        if(options.srgbToLinear)
+        {
+            const unsigned int colorChannels = formatChannelCount(pixelFormat) >= 3 ? 3 : 1;
+            Color4f* pixels = image.data();
+            parallelFor(
+              0,
+              static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+              grainSize,
+              [pixels, colorChannels](std::size_t begin, std::size_t end) {
+                  srgbToLinear(pixels + begin, pixels + begin, end - begin, colorChannels);
+              },
+              options.threadCount);
+        }
+        return true;
+    }
+    // stb_image probes the content of the file itself, it may still recognize it
+    if(options.srgbToLinear)
+    {
+        return decodeStbSrgbImage(path, image, pixelFormat, options.threadCount);
+    }
+    return decodeStb(path, image, pixelFormat, options.threadCount);
+}
+
+bool loadImage(const std::string& path, HalfImage& image)
+{
+    if(stbi_is_hdr(path.data()))
+    {
+        int width{};
+        int height{};
+        float* data = loadFloatImage(path, width, height, ImageFormat::RGBA32);
+        if(data == nullptr)
+        {
+            return false;
+        }
+        HalfImage halfImage(width, height);
+        convertPixels(reinterpret_cast<const Color4f*>(data),
+                      halfImage.data(),
+                      static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+        freeStbData(data);
+        image = std::move(halfImage);
+        return true;
+    }
+    Image decoded;
+    if(!loadImage(path, decoded, ImageFormat::RGBA32))
+    {
+        return false;
+    }
+    image = HalfImage(decoded);
+    return true;
+}
+
 } // namespace stbipp
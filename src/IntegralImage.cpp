@@ -0,0 +1,200 @@
+#include "stbipp/IntegralImage.hpp"
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+// Number of table entries summed by each task of the thread pool
+constexpr std::size_t grainSize = 16384;
+// Number of columns summed down the rows by each task, the entries of a block stay in the cache from a row to the next
+constexpr std::size_t columnBlockSize = 256;
+
+stbipp::Color4d toDouble(const stbipp::Color4f& color)
+{
+    return stbipp::Color4d(color.r(), color.g(), color.b(), color.a());
+}
+
+/**
+ * @brief Sum the rows of an image into a table with a null first row and column
+ * @param[in] image The image to sum
+ * @param[out] sums The (width + 1) x (height + 1) table of the sums of the values
+ * @param[out] squaredSums The table of the sums of the squared values, nullptr to skip it
+ * @param[in] threadCount Maximum number of threads used
+ */
+void sumRows(const stbipp::Image& image, stbipp::Color4d* sums, stbipp::Color4d* squaredSums, unsigned int threadCount)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    const std::size_t stride = width + 1;
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(image.height()),
+      std::max<std::size_t>(1, grainSize / stride),
+      [&](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              const stbipp::Color4f* pixels = image.data() + row * width;
+              stbipp::Color4d* sumRow = sums + (row + 1) * stride;
+              stbipp::Color4d sum{};
+              sumRow[0] = sum;
+              for(std::size_t column = 0; column < width; ++column)
+              {
+                  sum += toDouble(pixels[column]);
+                  sumRow[column + 1] = sum;
+              }
+              if(squaredSums == nullptr)
+              {
+                  continue;
+              }
+              stbipp::Color4d* squaredRow = squaredSums + (row + 1) * stride;
+              stbipp::Color4d squaredSum{};
+              squaredRow[0] = squaredSum;
+              for(std::size_t column = 0; column < width; ++column)
+              {
+                  const stbipp::Color4d value = toDouble(pixels[column]);
+                  squaredSum += value * value;
+                  squaredRow[column + 1] = squaredSum;
+              }
+          }
+      },
+      threadCount);
+}
+
+/**
+ * @brief Add each row of a table to the next one, so the row sums become rectangle sums
+ */
+void sumColumns(stbipp::Color4d* table, std::size_t stride, std::size_t rowCount, unsigned int threadCount)
+{
+    stbipp::parallelFor(
+      0,
+      (stride + columnBlockSize - 1) / columnBlockSize,
+      1,
+      [=](std::size_t blockBegin, std::size_t blockEnd) {
+          const std::size_t columnBegin = blockBegin * columnBlockSize;
+          const std::size_t columnEnd = std::min(blockEnd * columnBlockSize, stride);
+          for(std::size_t row = 1; row < rowCount; ++row)
+          {
+              const stbipp::Color4d* previous = table + (row - 1) * stride;
+              stbipp::Color4d* current = table + row * stride;
+              for(std::size_t column = columnBegin; column < columnEnd; ++column)
+              {
+                  current[column] += previous[column];
+              }
+          }
+      },
+      threadCount);
+}
+
+} // namespace
+
+namespace stbipp
+{
+IntegralImage::IntegralImage(const Image& image, bool squaredSums, unsigned int threadCount):
+  m_width(image.width()),
+  m_height(image.height())
+{
+    const std::size_t stride = static_cast<std::size_t>(m_width) + 1;
+    const std::size_t rowCount = static_cast<std::size_t>(m_height) + 1;
+    // The first row stays null, the other rows are fully written by sumRows
+    m_sums.resize(stride * rowCount);
+    if(squaredSums)
+    {
+        m_squaredSums.resize(stride * rowCount);
+    }
+    sumRows(image, m_sums.data(), squaredSums ? m_squaredSums.data() : nullptr, threadCount);
+    sumColumns(m_sums.data(), stride, rowCount, threadCount);
+    if(squaredSums)
+    {
+        sumColumns(m_squaredSums.data(), stride, rowCount, threadCount);
+    }
+}
+
+int IntegralImage::width() const
+{
+    return m_width;
+}
+
+int IntegralImage::height() const
+{
+    return m_height;
+}
+
+bool IntegralImage::hasSquaredSums() const
+{
+    return !m_squaredSums.empty();
+}
+
+Color4d IntegralImage::sum(const Rect& region) const
+{
+    return sumTable(m_sums, region);
+}
+
+Color4d IntegralImage::squaredSum(const Rect& region) const
+{
+    if(!hasSquaredSums())
+    {
+        throw std::logic_error("The integral image was built without the squared sums");
+    }
+    return sumTable(m_squaredSums, region);
+}
+
+Color4f IntegralImage::mean(const Rect& region) const
+{
+    const Rect clipped = intersect(region, Rect{0, 0, m_width, m_height});
+    if(clipped.isEmpty())
+    {
+        return Color4f{};
+    }
+    const Color4d mean = sumTable(m_sums, clipped) / (static_cast<double>(clipped.width) * clipped.height);
+    return Color4f(static_cast<float>(mean.r()),
+                   static_cast<float>(mean.g()),
+                   static_cast<float>(mean.b()),
+                   static_cast<float>(mean.a()));
+}
+
+Color4f IntegralImage::variance(const Rect& region) const
+{
+    if(!hasSquaredSums())
+    {
+        throw std::logic_error("The integral image was built without the squared sums");
+    }
+    const Rect clipped = intersect(region, Rect{0, 0, m_width, m_height});
+    if(clipped.isEmpty())
+    {
+        return Color4f{};
+    }
+    const double count = static_cast<double>(clipped.width) * clipped.height;
+    const Color4d mean = sumTable(m_sums, clipped) / count;
+    const Color4d squaredMean = sumTable(m_squaredSums, clipped) / count;
+    Color4f variance;
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        // Rounding errors may give slightly negative values for constant regions
+        variance[channel] = static_cast<float>(std::max(squaredMean[channel] - mean[channel] * mean[channel], 0.0));
+    }
+    return variance;
+}
+
+const Color4d* IntegralImage::data() const
+{
+    return m_sums.data();
+}
+
+Color4d IntegralImage::sumTable(const std::vector<Color4d>& table, const Rect& region) const
+{
+    const Rect clipped = intersect(region, Rect{0, 0, m_width, m_height});
+    if(clipped.isEmpty())
+    {
+        return Color4d{};
+    }
+    const std::size_t stride = static_cast<std::size_t>(m_width) + 1;
+    const std::size_t left = static_cast<std::size_t>(clipped.x);
+    const std::size_t right = left + static_cast<std::size_t>(clipped.width);
+    const Color4d* top = table.data() + static_cast<std::size_t>(clipped.y) * stride;
+    const Color4d* bottom = top + static_cast<std::size_t>(clipped.height) * stride;
+    return bottom[right] - bottom[left] - top[right] + top[left];
+}
+
+} // namespace stbipp
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "stbipp/BorderMode.hpp"
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace stbipp
+{
+namespace detail
+{
+// Positions are clamped to this magnitude so the pixel indices fit an int, farther pixels are all border pixels
+constexpr float sampleCoordinateLimit = 16777216.0f;
+
+/**
+ * @brief Weights of the pixels around a position, for the filters sampling tapCount x tapCount pixels
+ * The first tap is the pixel floor(position) - ((tapCount - 1) / 2).
+ */
+template<int tapCount>
+struct Taps;
+
+template<>
+struct Taps<1>
+{
+    static void weights(float, float* weights)
+    {
+        weights[0] = 1.0f;
+    }
+};
+
+template<>
+struct Taps<2>
+{
+    static void weights(float fraction, float* weights)
+    {
+        weights[0] = 1.0f - fraction;
+        weights[1] = fraction;
+    }
+};
+
+template<>
+struct Taps<4>
+{
+    // Catmull-Rom spline, the cubic of the resampling BICUBIC filter
+    static void weights(float t, float* weights)
+    {
+        weights[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+        weights[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+        weights[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+        weights[3] = (0.5f * t - 0.5f) * t * t;
+    }
+};
+
+/**
+ * @brief Interpolate an image at a position with a tapCount x tapCount filter
+ * The nearest filter is a single tap filter at the position rounded to the nearest pixel.
+ */
+template<int tapCount>
+Color4f samplePoint(const Image& image, float x, float y, BorderMode border, const Color4f& borderColor)
+{
+    if(std::isnan(x) || std::isnan(y))
+    {
+        return borderColor;
+    }
+    if(tapCount == 1)
+    {
+        x += 0.5f;
+        y += 0.5f;
+    }
+    x = std::min(std::max(x, -sampleCoordinateLimit), sampleCoordinateLimit);
+    y = std::min(std::max(y, -sampleCoordinateLimit), sampleCoordinateLimit);
+    const float floorX = std::floor(x);
+    const float floorY = std::floor(y);
+    float horizontalWeights[tapCount];
+    float verticalWeights[tapCount];
+    Taps<tapCount>::weights(x - floorX, horizontalWeights);
+    Taps<tapCount>::weights(y - floorY, verticalWeights);
+
+    const int width = image.width();
+    const int height = image.height();
+    const int left = static_cast<int>(floorX) - ((tapCount - 1) / 2);
+    const int top = static_cast<int>(floorY) - ((tapCount - 1) / 2);
+    const Color4f* pixels = image.data();
+    Color4f result{};
+    if(left >= 0 && top >= 0 && left + tapCount <= width && top + tapCount <= height)
+    {
+        // All the taps are inside the image, the common case
+        const Color4f* row = pixels + static_cast<std::size_t>(top) * width + left;
+        for(int tapY = 0; tapY < tapCount; ++tapY, row += width)
+        {
+            Color4f rowSum = row[0] * horizontalWeights[0];
+            for(int tapX = 1; tapX < tapCount; ++tapX)
+            {
+                rowSum += row[tapX] * horizontalWeights[tapX];
+            }
+            result += rowSum * verticalWeights[tapY];
+        }
+        return result;
+    }
+
+    int columns[tapCount];
+    for(int tapX = 0; tapX < tapCount; ++tapX)
+    {
+        columns[tapX] = borderIndex(left + tapX, width, border);
+    }
+    for(int tapY = 0; tapY < tapCount; ++tapY)
+    {
+        const int rowIndex = borderIndex(top + tapY, height, border);
+        Color4f rowSum{};
+        for(int tapX = 0; tapX < tapCount; ++tapX)
+        {
+            const bool inside = rowIndex >= 0 && columns[tapX] >= 0;
+            const Color4f& color =
+              inside ? pixels[static_cast<std::size_t>(rowIndex) * width + columns[tapX]] : borderColor;
+            rowSum += color * horizontalWeights[tapX];
+        }
+        result += rowSum * verticalWeights[tapY];
+    }
+    return result;
+}
+
+} // namespace detail
+} // namespace stbipp
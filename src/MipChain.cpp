@@ -0,0 +1,171 @@
+#include "stbipp/MipChain.hpp"
+
+#include "stbipp/Compositing.hpp"
+#include "stbipp/Parallel.hpp"
+#include "stbipp/Srgb.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Number of pixels converted by each task of the multithreaded conversions
+constexpr std::size_t grainSize = 16384;
+
+/**
+ * @brief Average each 2x2 block of the source row pair, same result as the box filter for even dimensions
+ */
+void averageBlocks(const stbipp::Color4f* top, const stbipp::Color4f* bottom, stbipp::Color4f* destination, int width)
+{
+    for(int column = 0; column < width; ++column)
+    {
+        stbipp::Color4f sum = top[2 * column];
+        sum += top[2 * column + 1];
+        sum += bottom[2 * column];
+        sum += bottom[2 * column + 1];
+        sum *= 0.25f;
+        destination[column] = sum;
+    }
+}
+
+} // namespace
+
+namespace stbipp
+{
+namespace detail
+{
+void buildMipLevels(const Image& image,
+                    ResampleFilter filter,
+                    const MipChainOptions& options,
+                    int levelCount,
+                    const MipRowWriter& writer)
+{
+    if(levelCount <= 0)
+    {
+        return;
+    }
+    const auto width = static_cast<std::size_t>(image.width());
+    parallelFor(
+      0,
+      static_cast<std::size_t>(image.height()),
+      std::max<std::size_t>(1, grainSize / std::max<std::size_t>(width, 1)),
+      [&](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              writer(0, static_cast<int>(row), image.data() + row * width);
+          }
+      },
+      options.threadCount);
+    if(levelCount == 1)
+    {
+        return;
+    }
+
+    // The levels are filtered in linear and premultiplied values, the first level is converted while it is read and
+    // the previous level is kept in floats
+    const bool toWorkingSpace = options.gammaCorrect || options.alphaWeighted;
+    const auto toWorkingRow = [&options](const Color4f* colors, Color4f* buffer, std::size_t count) {
+        if(options.gammaCorrect)
+        {
+            srgbToLinear(colors, buffer, count);
+            colors = buffer;
+        }
+        if(options.alphaWeighted)
+        {
+            copyPixels(colors, buffer, count);
+            premultiplyAlpha(buffer, count);
+        }
+        return static_cast<const Color4f*>(buffer);
+    };
+    Image working;
+    const Image* previous = &image;
+
+    for(int level = 1; level < levelCount; ++level)
+    {
+        const int levelWidth = std::max(image.width() >> level, 1);
+        const int levelHeight = std::max(image.height() >> level, 1);
+        const auto previousWidth = static_cast<std::size_t>(previous->width());
+        const bool convertRows = toWorkingSpace && previous == &image;
+        const auto readRow = [&](std::size_t row, Color4f* buffer) {
+            const Color4f* colors = previous->data() + previousWidth * row;
+            return convertRows ? toWorkingRow(colors, buffer, previousWidth) : colors;
+        };
+        const auto currentWidth = static_cast<std::size_t>(levelWidth);
+        Image current(levelWidth, levelHeight);
+        const auto storeRow = [&](int row, const Color4f* colors) {
+            Color4f* destination = current.data() + currentWidth * static_cast<std::size_t>(row);
+            copyPixels(colors, destination, currentWidth);
+            if(!toWorkingSpace)
+            {
+                writer(level, row, destination);
+                return;
+            }
+            std::vector<Color4f> encoded(colors, colors + currentWidth);
+            if(options.alphaWeighted)
+            {
+                unpremultiplyAlpha(encoded.data(), encoded.size());
+            }
+            if(options.gammaCorrect)
+            {
+                linearToSrgb(encoded.data(), encoded.data(), encoded.size());
+            }
+            writer(level, row, encoded.data());
+        };
+
+        if(filter == ResampleFilter::BOX && previous->width() == 2 * levelWidth &&
+           previous->height() == 2 * levelHeight)
+        {
+            // Power of two levels, each pixel is the average of a 2x2 block
+            parallelFor(
+              0,
+              static_cast<std::size_t>(levelHeight),
+              std::max<std::size_t>(1, grainSize / currentWidth),
+              [&](std::size_t begin, std::size_t end) {
+                  std::vector<Color4f> row(currentWidth);
+                  std::vector<Color4f> topBuffer(convertRows ? previousWidth : 0);
+                  std::vector<Color4f> bottomBuffer(convertRows ? previousWidth : 0);
+                  for(std::size_t y = begin; y < end; ++y)
+                  {
+                      const Color4f* top = readRow(2 * y, topBuffer.data());
+                      const Color4f* bottom = readRow(2 * y + 1, bottomBuffer.data());
+                      averageBlocks(top, bottom, row.data(), levelWidth);
+                      storeRow(static_cast<int>(y), row.data());
+                  }
+              },
+              options.threadCount);
+        }
+        else
+        {
+            detail::resampleRows(
+              previous->width(),
+              previous->height(),
+              levelWidth,
+              levelHeight,
+              filter,
+              options.threadCount,
+              [&readRow](int row, Color4f* buffer) { return readRow(static_cast<std::size_t>(row), buffer); },
+              storeRow);
+        }
+        working = std::move(current);
+        previous = &working;
+    }
+}
+} // namespace detail
+
+int mipLevelCount(int width, int height)
+{
+    if(width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+    int size = std::max(width, height);
+    int count = 1;
+    while(size > 1)
+    {
+        size >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+} // namespace stbipp
@@ -0,0 +1,374 @@
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using Task = std::function<void()>;
+
+/**
+ * @brief Tasks of a worker, the owner pops the latest ones while thieves take the oldest ones
+ */
+struct TaskQueue
+{
+    std::mutex mutex;
+    std::deque<Task> tasks;
+};
+
+// Pool and worker index of the current thread, a null pool for threads outside the pools
+thread_local const void* currentPool = nullptr;
+thread_local int currentWorkerIndex = -1;
+
+/**
+ * @brief Synchronisation of a parallel loop shared by its calling thread and its helper tasks
+ */
+struct LoopState
+{
+    std::atomic<std::size_t> nextChunk{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+    std::mutex mutex;
+    std::condition_variable finished;
+    unsigned int pendingHelpers{0};
+};
+
+} // namespace
+
+namespace stbipp
+{
+unsigned int hardwareThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+struct ThreadPool::State
+{
+    /**
+     * @brief Take a task, from the queue of the given worker first, then from the other queues
+     * @param[in] workerIndex Index of the calling worker, -1 for other threads
+     * @param[out] task The task taken
+     * @return true if a task was taken
+     */
+    bool takeTask(int workerIndex, Task& task)
+    {
+        if(workerIndex >= 0)
+        {
+            TaskQueue& queue = *queues[static_cast<std::size_t>(workerIndex)];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                --pendingCount;
+                return true;
+            }
+        }
+        const std::size_t queueCount = queues.size();
+        const std::size_t first = workerIndex >= 0 ? static_cast<std::size_t>(workerIndex) + 1 : 0;
+        for(std::size_t offset = 0; offset < queueCount; ++offset)
+        {
+            TaskQueue& queue = *queues[(first + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if(!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                --pendingCount;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Queue a task, in the queue of the calling worker or in the shared queue for other threads
+     */
+    void submit(Task task)
+    {
+        const std::size_t queueIndex =
+          currentPool == this ? static_cast<std::size_t>(currentWorkerIndex) : queues.size() - 1;
+        {
+            // The count is updated under the queue lock so the task can't be taken before it is counted
+            std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+            queues[queueIndex]->tasks.push_back(std::move(task));
+            ++pendingCount;
+        }
+        // Locking the sleep mutex ensures a worker checking the count is either waiting or sees the new task
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+
+    /**
+     * @brief Run a pending task in the calling thread
+     * @return true if a task was run
+     */
+    bool runPendingTask()
+    {
+        Task task;
+        if(!takeTask(currentPool == this ? currentWorkerIndex : -1, task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    void work(int workerIndex)
+    {
+        currentPool = this;
+        currentWorkerIndex = workerIndex;
+        while(true)
+        {
+            Task task;
+            if(takeTask(workerIndex, task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this]() { return stopping || pendingCount > 0; });
+            if(stopping && pendingCount == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    TaskObserver observer() const
+    {
+        std::lock_guard<std::mutex> lock(observerMutex);
+        return taskObserver;
+    }
+
+    // One queue per worker followed by the queue shared by the threads outside the pool
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<std::size_t> pendingCount{0};
+    bool stopping{false};
+    mutable std::mutex observerMutex;
+    TaskObserver taskObserver;
+};
+
+ThreadPool::ThreadPool(unsigned int workerCount): m_state(new State)
+{
+    for(unsigned int index = 0; index <= workerCount; ++index)
+    {
+        m_state->queues.emplace_back(new TaskQueue);
+    }
+    m_state->workers.reserve(workerCount);
+    for(unsigned int index = 0; index < workerCount; ++index)
+    {
+        State* state = m_state.get();
+        m_state->workers.emplace_back([state, index]() { state->work(static_cast<int>(index)); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->sleepMutex);
+        m_state->stopping = true;
+    }
+    m_state->wakeUp.notify_all();
+    for(auto& worker: m_state->workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global()
+{
+    static ThreadPool pool(hardwareThreadCount() - 1);
+    return pool;
+}
+
+unsigned int ThreadPool::workerCount() const
+{
+    return static_cast<unsigned int>(m_state->workers.size());
+}
+
+void ThreadPool::setTaskObserver(TaskObserver observer)
+{
+    std::lock_guard<std::mutex> lock(m_state->observerMutex);
+    m_state->taskObserver = std::move(observer);
+}
+
+void ThreadPool::parallelFor(std::size_t begin,
+                             std::size_t end,
+                             std::size_t grainSize,
+                             const std::function<void(std::size_t, std::size_t)>& body,
+                             unsigned int threadCount)
+{
+    if(begin >= end)
+    {
+        return;
+    }
+    grainSize = std::max<std::size_t>(grainSize, 1);
+    const std::size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+    const unsigned int maximumThreadCount = workerCount() + 1;
+    threadCount = threadCount == 0 ? maximumThreadCount : std::min(threadCount, maximumThreadCount);
+    threadCount = static_cast<unsigned int>(std::min<std::size_t>(threadCount, chunkCount));
+
+    const TaskObserver observer = m_state->observer();
+    const auto runChunk = [&](std::size_t chunkBegin, std::size_t chunkEnd) {
+        if(!observer)
+        {
+            body(chunkBegin, chunkEnd);
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        body(chunkBegin, chunkEnd);
+        const int workerIndex = currentPool == m_state.get() ? currentWorkerIndex : -1;
+        observer(TaskTiming{chunkBegin, chunkEnd, workerIndex, std::chrono::steady_clock::now() - start});
+    };
+
+    if(threadCount <= 1)
+    {
+        for(std::size_t chunkBegin = begin; chunkBegin < end; chunkBegin += std::min(grainSize, end - chunkBegin))
+        {
+            runChunk(chunkBegin, chunkBegin + std::min(grainSize, end - chunkBegin));
+        }
+        return;
+    }
+
+    LoopState loop;
+    const auto runChunks = [&]() {
+        std::size_t chunk;
+        while(!loop.failed && (chunk = loop.nextChunk++) < chunkCount)
+        {
+            const std::size_t chunkBegin = begin + chunk * grainSize;
+            try
+            {
+                runChunk(chunkBegin, chunkBegin + std::min(grainSize, end - chunkBegin));
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                if(!loop.exception)
+                {
+                    loop.exception = std::current_exception();
+                }
+                loop.failed = true;
+            }
+        }
+    };
+
+    loop.pendingHelpers = threadCount - 1;
+    for(unsigned int helper = 1; helper < threadCount; ++helper)
+    {
+        m_state->submit([&loop, &runChunks]() {
+            runChunks();
+            // The notification is sent under the lock so the loop state outlives it
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            --loop.pendingHelpers;
+            loop.finished.notify_all();
+        });
+    }
+    runChunks();
+
+    // Helpers still queued are run here, once the queues are empty the remaining helpers are running on the workers
+    while(true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            if(loop.pendingHelpers == 0)
+            {
+                break;
+            }
+        }
+        if(!m_state->runPendingTask())
+        {
+            std::unique_lock<std::mutex> lock(loop.mutex);
+            loop.finished.wait(lock, [&loop]() { return loop.pendingHelpers == 0; });
+        }
+    }
+
+    if(loop.exception)
+    {
+        std::rethrow_exception(loop.exception);
+    }
+}
+
+void parallelFor(std::size_t begin,
+                 std::size_t end,
+                 std::size_t grainSize,
+                 const std::function<void(std::size_t, std::size_t)>& body,
+                 unsigned int threadCount)
+{
+    ThreadPool::global().parallelFor(begin, end, grainSize, body, threadCount);
+}
+
+void parallelForTiles(int width,
+                      int height,
+                      int tileWidth,
+                      int tileHeight,
+                      const std::function<void(int x0, int y0, int x1, int y1)>& body,
+                      unsigned int threadCount)
+{
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+    tileWidth = std::max(tileWidth, 1);
+    tileHeight = std::max(tileHeight, 1);
+    const std::size_t columnCount = static_cast<std::size_t>((width + tileWidth - 1) / tileWidth);
+    const std::size_t rowCount = static_cast<std::size_t>((height + tileHeight - 1) / tileHeight);
+    parallelFor(
+      0,
+      columnCount * rowCount,
+      1,
+      [&](std::size_t tileBegin, std::size_t tileEnd) {
+          for(std::size_t tile = tileBegin; tile < tileEnd; ++tile)
+          {
+              const int x0 = static_cast<int>(tile % columnCount) * tileWidth;
+              const int y0 = static_cast<int>(tile / columnCount) * tileHeight;
+              body(x0, y0, std::min(x0 + tileWidth, width), std::min(y0 + tileHeight, height));
+          }
+      },
+      threadCount);
+}
+
+Executor::Executor(Function function): m_function(std::move(function))
+{
+    if(!m_function)
+    {
+        throw std::invalid_argument("An executor needs a function to run the chunks");
+    }
+}
+
+Executor Executor::serial()
+{
+    return parallel(1);
+}
+
+Executor Executor::pool(ThreadPool& pool, unsigned int threadCount)
+{
+    return Executor([&pool, threadCount](std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body) {
+        pool.parallelFor(begin, end, grainSize, body, threadCount);
+    });
+}
+
+Executor Executor::parallel(unsigned int threadCount)
+{
+    return Executor([threadCount](std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body) {
+        parallelFor(begin, end, grainSize, body, threadCount);
+    });
+}
+
+void Executor::run(std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body) const
+{
+    m_function(begin, end, grainSize, body);
+}
+
+} // namespace stbipp
@@ -0,0 +1,640 @@
+#include "PngEncoder.hpp"
+
+#include "Checksum.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace
+{
+using Bytes = std::vector<unsigned char>;
+
+const std::size_t windowSize = 32768;
+const std::size_t minMatchLength = 3;
+const std::size_t maxMatchLength = 258;
+const unsigned int hashBits = 15;
+const std::size_t maxStoredBlockSize = 65535;
+const std::uint32_t adlerModulo = 65521;
+
+// Bands smaller than this are not worth the compression lost by restarting the LZ77 window
+const std::size_t minBandSize = 256 * 1024;
+// Keeps the match positions of a band in 32 bits integers and each IDAT chunk far below its 2^31 size limit
+const std::size_t maxBandSize = 32 * 1024 * 1024;
+
+const std::uint16_t lengthBase[] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const std::uint8_t lengthExtraBits[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const std::uint16_t distanceBase[] = {1,    2,    3,    4,    5,    7,    9,    13,    17,    25,
+                                      33,   49,   65,   97,   129,  193,  257,  385,   513,   769,
+                                      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const std::uint8_t distanceExtraBits[] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                          6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+struct HuffmanCode
+{
+    std::uint16_t code;  /// Code with its bits reversed, ready to be written LSB first
+    std::uint8_t length; /// Number of bits of the code
+};
+
+std::uint16_t reverseBits(unsigned int value, unsigned int bitCount)
+{
+    unsigned int result = 0;
+    for(unsigned int bit = 0; bit < bitCount; ++bit)
+    {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+    return static_cast<std::uint16_t>(result);
+}
+
+/**
+ * @brief Codes of the fixed Huffman alphabets defined by RFC 1951 section 3.2.6
+ */
+struct FixedHuffmanTables
+{
+    std::array<HuffmanCode, 288> literals;
+    std::array<HuffmanCode, 30> distances;
+    std::array<std::uint8_t, maxMatchLength + 1> lengthSymbols; /// Index in lengthBase of each match length
+
+    FixedHuffmanTables()
+    {
+        for(unsigned int symbol = 0; symbol < literals.size(); ++symbol)
+        {
+            if(symbol < 144)
+            {
+                literals[symbol] = {reverseBits(0x30 + symbol, 8), 8};
+            }
+            else if(symbol < 256)
+            {
+                literals[symbol] = {reverseBits(0x190 + symbol - 144, 9), 9};
+            }
+            else if(symbol < 280)
+            {
+                literals[symbol] = {reverseBits(symbol - 256, 7), 7};
+            }
+            else
+            {
+                literals[symbol] = {reverseBits(0xC0 + symbol - 280, 8), 8};
+            }
+        }
+        for(unsigned int symbol = 0; symbol < distances.size(); ++symbol)
+        {
+            distances[symbol] = {reverseBits(symbol, 5), 5};
+        }
+        for(std::size_t length = minMatchLength; length <= maxMatchLength; ++length)
+        {
+            lengthSymbols[length] = static_cast<std::uint8_t>(
+              std::upper_bound(std::begin(lengthBase), std::end(lengthBase), length) - std::begin(lengthBase) - 1);
+        }
+    }
+};
+
+const FixedHuffmanTables& fixedHuffmanTables()
+{
+    static const FixedHuffmanTables tables;
+    return tables;
+}
+
+unsigned int distanceSymbol(std::size_t distance)
+{
+    return static_cast<unsigned int>(std::upper_bound(std::begin(distanceBase), std::end(distanceBase), distance) -
+                                     std::begin(distanceBase) - 1);
+}
+
+/**
+ * @brief LZ77 search parameters of a compression level
+ */
+struct DeflateParameters
+{
+    unsigned int maxChainLength; /// Maximum number of previous occurrences tested for a match
+    std::size_t niceLength;      /// Stop searching once a match this long is found
+    bool lazyMatching;           /// Test if the next position gives a longer match before emitting one
+};
+
+DeflateParameters deflateParameters(int compressionLevel)
+{
+    static const DeflateParameters parameters[] = {{0, 0, false},
+                                                   {4, 8, false},
+                                                   {8, 16, false},
+                                                   {16, 32, false},
+                                                   {16, 16, true},
+                                                   {32, 32, true},
+                                                   {128, 128, true},
+                                                   {256, 258, true},
+                                                   {1024, 258, true},
+                                                   {4096, 258, true}};
+    return parameters[std::min(std::max(compressionLevel, 0), 9)];
+}
+
+class BitWriter
+{
+  public:
+    explicit BitWriter(Bytes& output): m_output(output) {}
+
+    void write(std::uint32_t bits, unsigned int bitCount)
+    {
+        m_buffer |= static_cast<std::uint64_t>(bits) << m_bitCount;
+        m_bitCount += bitCount;
+        while(m_bitCount >= 8)
+        {
+            m_output.push_back(static_cast<unsigned char>(m_buffer));
+            m_buffer >>= 8;
+            m_bitCount -= 8;
+        }
+    }
+
+    void alignToByte()
+    {
+        if(m_bitCount > 0)
+        {
+            write(0, 8 - m_bitCount);
+        }
+    }
+
+    void writeAlignedBytes(const unsigned char* data, std::size_t size)
+    {
+        m_output.insert(m_output.end(), data, data + size);
+    }
+
+  private:
+    Bytes& m_output;
+    std::uint64_t m_buffer{0};
+    unsigned int m_bitCount{0};
+};
+
+/**
+ * @brief Write data as non final stored blocks
+ */
+void deflateStored(const unsigned char* data, std::size_t size, BitWriter& writer)
+{
+    for(std::size_t offset = 0; offset < size; offset += maxStoredBlockSize)
+    {
+        const auto blockSize = static_cast<std::uint32_t>(std::min(maxStoredBlockSize, size - offset));
+        writer.write(0, 3);
+        writer.alignToByte();
+        writer.write(blockSize, 16);
+        writer.write(~blockSize & 0xFFFF, 16);
+        writer.writeAlignedBytes(data + offset, blockSize);
+    }
+}
+
+/**
+ * @brief Write data as a non final fixed Huffman block followed by an empty stored block, so the output ends on a
+ * byte boundary and can be concatenated with the output of the next band
+ */
+void deflateFixed(const unsigned char* data, std::size_t size, const DeflateParameters& parameters, BitWriter& writer)
+{
+    const auto& tables = fixedHuffmanTables();
+    std::vector<std::int32_t> head(std::size_t(1) << hashBits, -1);
+    std::vector<std::int32_t> previous(windowSize, -1);
+
+    const auto hash = [data](std::size_t position) {
+        const std::uint32_t value = data[position] | (data[position + 1] << 8) | (data[position + 2] << 16);
+        return (value * 2654435761u) >> (32 - hashBits);
+    };
+    const auto insert = [&](std::size_t position) {
+        if(position + minMatchLength <= size)
+        {
+            auto& first = head[hash(position)];
+            previous[position & (windowSize - 1)] = first;
+            first = static_cast<std::int32_t>(position);
+        }
+    };
+    const auto findMatch = [&](std::size_t position, std::size_t& matchDistance) -> std::size_t {
+        const std::size_t maxLength = std::min(maxMatchLength, size - position);
+        if(maxLength < minMatchLength)
+        {
+            return 0;
+        }
+        std::size_t bestLength = 0;
+        std::int32_t candidate = head[hash(position)];
+        for(unsigned int chain = 0; candidate >= 0 && chain < parameters.maxChainLength; ++chain)
+        {
+            const std::size_t distance = position - static_cast<std::size_t>(candidate);
+            if(distance >= windowSize)
+            {
+                break;
+            }
+            const unsigned char* reference = data + candidate;
+            if(reference[bestLength] == data[position + bestLength])
+            {
+                std::size_t length = 0;
+                while(length < maxLength && reference[length] == data[position + length])
+                {
+                    ++length;
+                }
+                if(length > bestLength)
+                {
+                    bestLength = length;
+                    matchDistance = distance;
+                    if(length >= parameters.niceLength || length == maxLength)
+                    {
+                        break;
+                    }
+                }
+            }
+            candidate = previous[static_cast<std::size_t>(candidate) & (windowSize - 1)];
+        }
+        return bestLength >= minMatchLength ? bestLength : 0;
+    };
+    const auto writeSymbol = [&](unsigned int symbol) {
+        writer.write(tables.literals[symbol].code, tables.literals[symbol].length);
+    };
+    const auto writeMatch = [&](std::size_t length, std::size_t distance) {
+        const unsigned int lengthIndex = tables.lengthSymbols[length];
+        writeSymbol(257 + lengthIndex);
+        writer.write(static_cast<std::uint32_t>(length - lengthBase[lengthIndex]), lengthExtraBits[lengthIndex]);
+        const unsigned int distanceIndex = distanceSymbol(distance);
+        writer.write(tables.distances[distanceIndex].code, tables.distances[distanceIndex].length);
+        writer.write(static_cast<std::uint32_t>(distance - distanceBase[distanceIndex]),
+                     distanceExtraBits[distanceIndex]);
+    };
+
+    writer.write(0, 1); // Not the final block
+    writer.write(1, 2); // Fixed Huffman codes
+
+    std::size_t position = 0;
+    std::size_t length = 0;
+    std::size_t distance = 0;
+    bool matchKnown = false;
+    while(position < size)
+    {
+        if(!matchKnown)
+        {
+            length = findMatch(position, distance);
+        }
+        matchKnown = false;
+        insert(position);
+        if(length == 0)
+        {
+            writeSymbol(data[position]);
+            ++position;
+            continue;
+        }
+        if(parameters.lazyMatching && length < parameters.niceLength)
+        {
+            std::size_t nextDistance = 0;
+            const std::size_t nextLength = findMatch(position + 1, nextDistance);
+            if(nextLength > length)
+            {
+                writeSymbol(data[position]);
+                ++position;
+                length = nextLength;
+                distance = nextDistance;
+                matchKnown = true;
+                continue;
+            }
+        }
+        writeMatch(length, distance);
+        for(std::size_t offset = 1; offset < length; ++offset)
+        {
+            insert(position + offset);
+        }
+        position += length;
+    }
+    writeSymbol(256); // End of block
+
+    // Empty stored block to align the stream on a byte boundary
+    writer.write(0, 3);
+    writer.alignToByte();
+    writer.write(0x0000, 16);
+    writer.write(0xFFFF, 16);
+}
+
+std::uint32_t adler32(const unsigned char* data, std::size_t size)
+{
+    // Largest number of bytes that can be summed before the 32 bits sums overflow
+    const std::size_t maxRunLength = 5552;
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+    while(size > 0)
+    {
+        const std::size_t runLength = std::min(size, maxRunLength);
+        for(std::size_t index = 0; index < runLength; ++index)
+        {
+            a += data[index];
+            b += a;
+        }
+        a %= adlerModulo;
+        b %= adlerModulo;
+        data += runLength;
+        size -= runLength;
+    }
+    return (b << 16) | a;
+}
+
+/**
+ * @brief Compute the adler32 checksum of the concatenation of two buffers from their own checksums
+ * @param[in] first Checksum of the first buffer
+ * @param[in] second Checksum of the second buffer
+ * @param[in] secondSize Size of the second buffer
+ */
+std::uint32_t combineAdler32(std::uint32_t first, std::uint32_t second, std::size_t secondSize)
+{
+    const std::uint32_t remainder = static_cast<std::uint32_t>(secondSize % adlerModulo);
+    std::uint32_t a = first & 0xFFFF;
+    std::uint32_t b = (remainder * a) % adlerModulo;
+    a += (second & 0xFFFF) + adlerModulo - 1;
+    b += (first >> 16) + (second >> 16) + adlerModulo - remainder;
+    if(a >= adlerModulo)
+    {
+        a -= adlerModulo;
+    }
+    if(a >= adlerModulo)
+    {
+        a -= adlerModulo;
+    }
+    if(b >= (adlerModulo << 1))
+    {
+        b -= (adlerModulo << 1);
+    }
+    if(b >= adlerModulo)
+    {
+        b -= adlerModulo;
+    }
+    return (b << 16) | a;
+}
+
+void appendBigEndian(Bytes& output, std::uint32_t value)
+{
+    output.push_back(static_cast<unsigned char>(value >> 24));
+    output.push_back(static_cast<unsigned char>(value >> 16));
+    output.push_back(static_cast<unsigned char>(value >> 8));
+    output.push_back(static_cast<unsigned char>(value));
+}
+
+void storeBigEndian(unsigned char* output, std::uint32_t value)
+{
+    output[0] = static_cast<unsigned char>(value >> 24);
+    output[1] = static_cast<unsigned char>(value >> 16);
+    output[2] = static_cast<unsigned char>(value >> 8);
+    output[3] = static_cast<unsigned char>(value);
+}
+
+/**
+ * @brief Start a PNG chunk, the data must then be appended and the chunk closed with endChunk
+ * @return Offset of the chunk in output
+ */
+std::size_t beginChunk(Bytes& output, const char* type)
+{
+    const std::size_t offset = output.size();
+    output.resize(offset + 4);
+    output.insert(output.end(), type, type + 4);
+    return offset;
+}
+
+void endChunk(Bytes& output, std::size_t chunkOffset)
+{
+    const std::size_t dataSize = output.size() - chunkOffset - 8;
+    storeBigEndian(output.data() + chunkOffset, static_cast<std::uint32_t>(dataSize));
+    appendBigEndian(output, stbipp::crc32(output.data() + chunkOffset + 4, dataSize + 4));
+}
+
+unsigned char paethPredictor(int left, int up, int upLeft)
+{
+    const int estimate = left + up - upLeft;
+    const int leftDistance = std::abs(estimate - left);
+    const int upDistance = std::abs(estimate - up);
+    const int upLeftDistance = std::abs(estimate - upLeft);
+    if(leftDistance <= upDistance && leftDistance <= upLeftDistance)
+    {
+        return static_cast<unsigned char>(left);
+    }
+    return static_cast<unsigned char>(upDistance <= upLeftDistance ? up : upLeft);
+}
+
+/**
+ * @brief Apply one of the PNG row filters (0: None, 1: Sub, 2: Up, 3: Average, 4: Paeth)
+ * @param[in] row Row to filter
+ * @param[in] prior Previous row, or zeros for the first row of the image
+ * @param[out] output Filtered row
+ */
+void applyFilter(int filter,
+                 const unsigned char* row,
+                 const unsigned char* prior,
+                 std::size_t size,
+                 int bpp,
+                 unsigned char* output)
+{
+    const std::size_t pixelSize = static_cast<std::size_t>(bpp);
+    switch(filter)
+    {
+        case 1:
+            std::copy(row, row + pixelSize, output);
+            for(std::size_t index = pixelSize; index < size; ++index)
+            {
+                output[index] = static_cast<unsigned char>(row[index] - row[index - pixelSize]);
+            }
+            break;
+        case 2:
+            for(std::size_t index = 0; index < size; ++index)
+            {
+                output[index] = static_cast<unsigned char>(row[index] - prior[index]);
+            }
+            break;
+        case 3:
+            for(std::size_t index = 0; index < pixelSize; ++index)
+            {
+                output[index] = static_cast<unsigned char>(row[index] - (prior[index] >> 1));
+            }
+            for(std::size_t index = pixelSize; index < size; ++index)
+            {
+                output[index] = static_cast<unsigned char>(row[index] - ((row[index - pixelSize] + prior[index]) >> 1));
+            }
+            break;
+        case 4:
+            for(std::size_t index = 0; index < pixelSize; ++index)
+            {
+                output[index] = static_cast<unsigned char>(row[index] - prior[index]);
+            }
+            for(std::size_t index = pixelSize; index < size; ++index)
+            {
+                output[index] = static_cast<unsigned char>(
+                  row[index] - paethPredictor(row[index - pixelSize], prior[index], prior[index - pixelSize]));
+            }
+            break;
+        default: std::copy(row, row + size, output); break;
+    }
+}
+
+/**
+ * @brief Pick the filter minimizing the sum of absolute differences of the filtered row, the heuristic
+ * recommended by the PNG specification and used by stb_image_write
+ */
+int selectFilter(const unsigned char* row, const unsigned char* prior, std::size_t size, int bpp, Bytes& scratch)
+{
+    int bestFilter = 0;
+    std::size_t bestCost = std::numeric_limits<std::size_t>::max();
+    for(int filter = 0; filter < 5; ++filter)
+    {
+        applyFilter(filter, row, prior, size, bpp, scratch.data());
+        std::size_t cost = 0;
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            cost += static_cast<std::size_t>(std::abs(static_cast<int>(static_cast<signed char>(scratch[index]))));
+        }
+        if(cost < bestCost)
+        {
+            bestCost = cost;
+            bestFilter = filter;
+        }
+    }
+    return bestFilter;
+}
+
+/**
+ * @brief Compressed rows of the image, stored as a complete IDAT chunk
+ */
+struct Band
+{
+    Bytes chunk;
+    std::uint32_t adler{};
+    std::size_t filteredSize{};
+};
+
+void encodeBand(const unsigned char* data,
+                int width,
+                int channels,
+                int firstRow,
+                int lastRow,
+                bool isFirstBand,
+                const stbipp::PngEncoderSettings& settings,
+                Band& band)
+{
+    const std::size_t stride = static_cast<std::size_t>(width) * static_cast<std::size_t>(channels);
+    const std::size_t rowCount = static_cast<std::size_t>(lastRow - firstRow);
+    const int compressionLevel = std::min(std::max(settings.compressionLevel, 0), 9);
+
+    Bytes filtered(rowCount * (stride + 1));
+    Bytes scratch(stride);
+    const Bytes zeros(stride, 0);
+    for(std::size_t rowIndex = 0; rowIndex < rowCount; ++rowIndex)
+    {
+        const std::size_t imageRow = static_cast<std::size_t>(firstRow) + rowIndex;
+        const unsigned char* row = data + imageRow * stride;
+        const unsigned char* prior = imageRow > 0 ? row - stride : zeros.data();
+        unsigned char* output = filtered.data() + rowIndex * (stride + 1);
+        int filter = static_cast<int>(settings.filter) - static_cast<int>(stbipp::PngFilter::NONE);
+        if(settings.filter == stbipp::PngFilter::ADAPTIVE)
+        {
+            filter = compressionLevel == 0 ? 0 : selectFilter(row, prior, stride, channels, scratch);
+        }
+        output[0] = static_cast<unsigned char>(filter);
+        applyFilter(filter, row, prior, stride, channels, output + 1);
+    }
+    band.adler = adler32(filtered.data(), filtered.size());
+    band.filteredSize = filtered.size();
+
+    band.chunk.reserve(filtered.size() / 2 + 64);
+    const std::size_t chunkOffset = beginChunk(band.chunk, "IDAT");
+    if(isFirstBand)
+    {
+        static const unsigned char levelFlags[] = {0x01, 0x01, 0x5E, 0x5E, 0x5E, 0x5E, 0x9C, 0xDA, 0xDA, 0xDA};
+        band.chunk.push_back(0x78);
+        band.chunk.push_back(levelFlags[compressionLevel]);
+    }
+    BitWriter writer(band.chunk);
+    if(compressionLevel == 0)
+    {
+        deflateStored(filtered.data(), filtered.size(), writer);
+    }
+    else
+    {
+        deflateFixed(filtered.data(), filtered.size(), deflateParameters(compressionLevel), writer);
+    }
+    endChunk(band.chunk, chunkOffset);
+}
+
+} // namespace
+
+namespace stbipp
+{
+bool writePng(const std::string& path,
+              int width,
+              int height,
+              int channels,
+              const unsigned char* data,
+              const PngEncoderSettings& settings)
+{
+    if(width <= 0 || height <= 0 || channels < 1 || channels > 4 || data == nullptr)
+    {
+        return false;
+    }
+
+    const std::size_t totalSize =
+      static_cast<std::size_t>(height) * (static_cast<std::size_t>(width) * static_cast<std::size_t>(channels) + 1);
+    const unsigned int threadCount = settings.threadCount == 0 ? hardwareThreadCount() : settings.threadCount;
+    // Several bands per thread balance the load when some parts of the image compress slower than others
+    std::size_t bandCount = threadCount > 1 ? threadCount * 4 : 1;
+    bandCount = std::min(bandCount, std::max<std::size_t>(totalSize / minBandSize, 1));
+    bandCount = std::max(bandCount, (totalSize + maxBandSize - 1) / maxBandSize);
+    bandCount = std::min(bandCount, static_cast<std::size_t>(height));
+    const std::size_t rowsPerBand = (static_cast<std::size_t>(height) + bandCount - 1) / bandCount;
+    bandCount = (static_cast<std::size_t>(height) + rowsPerBand - 1) / rowsPerBand;
+
+    std::vector<Band> bands(bandCount);
+    parallelFor(
+      0,
+      bandCount,
+      1,
+      [&](std::size_t firstBand, std::size_t lastBand) {
+          for(std::size_t bandIndex = firstBand; bandIndex < lastBand; ++bandIndex)
+          {
+              const auto firstRow = static_cast<int>(bandIndex * rowsPerBand);
+              const auto lastRow = static_cast<int>(std::min((bandIndex + 1) * rowsPerBand, std::size_t(height)));
+              encodeBand(data, width, channels, firstRow, lastRow, bandIndex == 0, settings, bands[bandIndex]);
+          }
+      },
+      threadCount);
+
+    static const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static const unsigned char colorTypes[] = {0, 4, 2, 6};
+    Bytes header(std::begin(signature), std::end(signature));
+    const std::size_t headerOffset = beginChunk(header, "IHDR");
+    appendBigEndian(header, static_cast<std::uint32_t>(width));
+    appendBigEndian(header, static_cast<std::uint32_t>(height));
+    header.push_back(8); // Bit depth
+    header.push_back(colorTypes[channels - 1]);
+    header.push_back(0); // Deflate compression
+    header.push_back(0); // Adaptive filtering
+    header.push_back(0); // No interlacing
+    endChunk(header, headerOffset);
+
+    std::uint32_t adler = bands.front().adler;
+    for(std::size_t bandIndex = 1; bandIndex < bandCount; ++bandIndex)
+    {
+        adler = combineAdler32(adler, bands[bandIndex].adler, bands[bandIndex].filteredSize);
+    }
+    Bytes trailer;
+    const std::size_t trailerOffset = beginChunk(trailer, "IDAT");
+    trailer.push_back(0x03); // Final empty fixed Huffman block
+    trailer.push_back(0x00);
+    appendBigEndian(trailer, adler);
+    endChunk(trailer, trailerOffset);
+    endChunk(trailer, beginChunk(trailer, "IEND"));
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    for(const auto& band: bands)
+    {
+        file.write(reinterpret_cast<const char*>(band.chunk.data()), static_cast<std::streamsize>(band.chunk.size()));
+    }
+    file.write(reinterpret_cast<const char*>(trailer.data()), static_cast<std::streamsize>(trailer.size()));
+    file.close();
+    return !file.fail();
+}
+
+} // namespace stbipp
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "stbipp/ImageExporter.hpp"
+
+#include <string>
+
+namespace stbipp
+{
+/**
+ * @brief Encode 8 bits per channel pixels as a PNG file
+ * The image is split in row bands which are filtered and deflated independently on several threads, each band
+ * ending on a byte boundary so the compressed bands concatenate into a single valid zlib stream.
+ * @param[in] path Path to the file to write
+ * @param[in] width Image width
+ * @param[in] height Image height
+ * @param[in] channels Number of channels per pixel (1 to 4)
+ * @param[in] data Pointer to width * height * channels tightly packed values
+ * @param[in] settings Encoder settings
+ * @return true if the file was written successfully
+ */
+bool writePng(const std::string& path,
+              int width,
+              int height,
+              int channels,
+              const unsigned char* data,
+              const PngEncoderSettings& settings);
+
+} // namespace stbipp
@@ -0,0 +1,479 @@
+#include "stbipp/QoiCodec.hpp"
+
+#include "BuiltinCodecs.hpp"
+#include "stbipp/Srgb.hpp"
+#include "stbipp/ToneMapping.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+const unsigned char opIndex = 0x00;
+const unsigned char opDiff = 0x40;
+const unsigned char opLuma = 0x80;
+const unsigned char opRun = 0xC0;
+const unsigned char opRgb = 0xFE;
+const unsigned char opRgba = 0xFF;
+const unsigned char opMask = 0xC0;
+
+const int maxRunLength = 62;
+const std::size_t headerSize = 14;
+const unsigned char endMarker[] = {0, 0, 0, 0, 0, 0, 0, 1};
+// Same limit as the reference implementation, protects against corrupted headers
+const std::uint64_t maxPixelCount = 400000000;
+
+struct Pixel
+{
+    unsigned char r{0};
+    unsigned char g{0};
+    unsigned char b{0};
+    unsigned char a{255};
+
+    bool operator==(const Pixel& other) const
+    {
+        return r == other.r && g == other.g && b == other.b && a == other.a;
+    }
+};
+
+/**
+ * @brief Create the index of the previously seen pixels, every entry starts zeroed, alpha included
+ */
+std::array<Pixel, 64> createIndex()
+{
+    std::array<Pixel, 64> index;
+    for(auto& pixel : index)
+    {
+        pixel.a = 0;
+    }
+    return index;
+}
+
+unsigned int hashPixel(const Pixel& pixel)
+{
+    return (pixel.r * 3u + pixel.g * 5u + pixel.b * 7u + pixel.a * 11u) % 64u;
+}
+
+void storeBigEndian(unsigned char* output, std::uint32_t value)
+{
+    output[0] = static_cast<unsigned char>(value >> 24);
+    output[1] = static_cast<unsigned char>(value >> 16);
+    output[2] = static_cast<unsigned char>(value >> 8);
+    output[3] = static_cast<unsigned char>(value);
+}
+
+std::uint32_t loadBigEndian(const unsigned char* input)
+{
+    return (static_cast<std::uint32_t>(input[0]) << 24) | (static_cast<std::uint32_t>(input[1]) << 16) |
+           (static_cast<std::uint32_t>(input[2]) << 8) | static_cast<std::uint32_t>(input[3]);
+}
+
+unsigned char toUnsignedChar(float value)
+{
+    return stbipp::detail::ChannelConverter<float, unsigned char>{}(value);
+}
+
+} // namespace
+
+namespace stbipp
+{
+struct QoiWriter::State
+{
+    std::ofstream file;
+    int width{0};
+    int height{0};
+    int channels{0};
+    int writtenRows{0};
+    int run{0};
+    Pixel previous;
+    std::array<Pixel, 64> index = createIndex();
+    std::vector<unsigned char> buffer;
+
+    void flushRun()
+    {
+        if(run > 0)
+        {
+            buffer.push_back(static_cast<unsigned char>(opRun | (run - 1)));
+            run = 0;
+        }
+    }
+
+    void encode(const Pixel& pixel)
+    {
+        if(pixel == previous)
+        {
+            if(++run == maxRunLength)
+            {
+                flushRun();
+            }
+            return;
+        }
+        flushRun();
+
+        auto& cached = index[hashPixel(pixel)];
+        if(cached == pixel)
+        {
+            buffer.push_back(static_cast<unsigned char>(opIndex | hashPixel(pixel)));
+        }
+        else
+        {
+            cached = pixel;
+            if(pixel.a == previous.a)
+            {
+                const int dr = static_cast<signed char>(pixel.r - previous.r);
+                const int dg = static_cast<signed char>(pixel.g - previous.g);
+                const int db = static_cast<signed char>(pixel.b - previous.b);
+                const int drg = dr - dg;
+                const int dbg = db - dg;
+                if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                {
+                    buffer.push_back(static_cast<unsigned char>(opDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                }
+                else if(drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7)
+                {
+                    buffer.push_back(static_cast<unsigned char>(opLuma | (dg + 32)));
+                    buffer.push_back(static_cast<unsigned char>((drg + 8) << 4 | (dbg + 8)));
+                }
+                else
+                {
+                    buffer.insert(buffer.end(), {opRgb, pixel.r, pixel.g, pixel.b});
+                }
+            }
+            else
+            {
+                buffer.insert(buffer.end(), {opRgba, pixel.r, pixel.g, pixel.b, pixel.a});
+            }
+        }
+        previous = pixel;
+    }
+};
+
+QoiWriter::QoiWriter(const std::string& path, int width, int height, int channels, bool linear): m_state(new State)
+{
+    if(width <= 0 || height <= 0 || (channels != 3 && channels != 4) ||
+       static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height) > maxPixelCount)
+    {
+        return;
+    }
+    m_state->file.open(path, std::ios::binary);
+    if(!m_state->file)
+    {
+        return;
+    }
+    m_state->width = width;
+    m_state->height = height;
+    m_state->channels = channels;
+
+    unsigned char header[headerSize] = {'q', 'o', 'i', 'f'};
+    storeBigEndian(header + 4, static_cast<std::uint32_t>(width));
+    storeBigEndian(header + 8, static_cast<std::uint32_t>(height));
+    header[12] = static_cast<unsigned char>(channels);
+    header[13] = linear ? 1 : 0;
+    m_state->file.write(reinterpret_cast<const char*>(header), headerSize);
+    m_state->buffer.reserve(static_cast<std::size_t>(width) * 5 + sizeof(endMarker));
+}
+
+QoiWriter::~QoiWriter()
+{
+    close();
+}
+
+bool QoiWriter::isOpen() const
+{
+    return m_state->file.is_open() && m_state->channels > 0;
+}
+
+bool QoiWriter::writeRow(const unsigned char* row)
+{
+    if(!isOpen() || m_state->writtenRows >= m_state->height)
+    {
+        return false;
+    }
+    auto& state = *m_state;
+    state.buffer.clear();
+    Pixel pixel;
+    for(int column = 0; column < state.width; ++column, row += state.channels)
+    {
+        pixel.r = row[0];
+        pixel.g = row[1];
+        pixel.b = row[2];
+        if(state.channels == 4)
+        {
+            pixel.a = row[3];
+        }
+        state.encode(pixel);
+    }
+    if(++state.writtenRows == state.height)
+    {
+        state.flushRun();
+        state.buffer.insert(state.buffer.end(), std::begin(endMarker), std::end(endMarker));
+    }
+    state.file.write(reinterpret_cast<const char*>(state.buffer.data()),
+                     static_cast<std::streamsize>(state.buffer.size()));
+    return static_cast<bool>(state.file);
+}
+
+bool QoiWriter::close()
+{
+    if(!m_state->file.is_open())
+    {
+        return false;
+    }
+    const bool complete = isOpen() && m_state->writtenRows == m_state->height;
+    m_state->file.close();
+    return complete && !m_state->file.fail();
+}
+
+struct QoiReader::State
+{
+    std::ifstream file;
+    int width{0};
+    int height{0};
+    int channels{0};
+    bool linear{false};
+    int readRows{0};
+    int run{0};
+    Pixel pixel;
+    std::array<Pixel, 64> index = createIndex();
+    std::vector<unsigned char> buffer;
+    std::size_t position{0};
+    std::size_t size{0};
+
+    bool nextByte(unsigned char& value)
+    {
+        if(position == size)
+        {
+            file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            size = static_cast<std::size_t>(file.gcount());
+            position = 0;
+            if(size == 0)
+            {
+                return false;
+            }
+        }
+        value = buffer[position++];
+        return true;
+    }
+
+    bool decode()
+    {
+        if(run > 0)
+        {
+            --run;
+            return true;
+        }
+        unsigned char op;
+        if(!nextByte(op))
+        {
+            return false;
+        }
+        if(op == opRgb)
+        {
+            if(!nextByte(pixel.r) || !nextByte(pixel.g) || !nextByte(pixel.b))
+            {
+                return false;
+            }
+        }
+        else if(op == opRgba)
+        {
+            if(!nextByte(pixel.r) || !nextByte(pixel.g) || !nextByte(pixel.b) || !nextByte(pixel.a))
+            {
+                return false;
+            }
+        }
+        else if((op & opMask) == opIndex)
+        {
+            pixel = index[op];
+        }
+        else if((op & opMask) == opDiff)
+        {
+            pixel.r = static_cast<unsigned char>(pixel.r + ((op >> 4) & 0x03) - 2);
+            pixel.g = static_cast<unsigned char>(pixel.g + ((op >> 2) & 0x03) - 2);
+            pixel.b = static_cast<unsigned char>(pixel.b + (op & 0x03) - 2);
+        }
+        else if((op & opMask) == opLuma)
+        {
+            unsigned char second;
+            if(!nextByte(second))
+            {
+                return false;
+            }
+            const int dg = (op & 0x3F) - 32;
+            pixel.r = static_cast<unsigned char>(pixel.r + dg - 8 + ((second >> 4) & 0x0F));
+            pixel.g = static_cast<unsigned char>(pixel.g + dg);
+            pixel.b = static_cast<unsigned char>(pixel.b + dg - 8 + (second & 0x0F));
+        }
+        else
+        {
+            run = op & 0x3F;
+        }
+        index[hashPixel(pixel)] = pixel;
+        return true;
+    }
+};
+
+QoiReader::QoiReader(const std::string& path): m_state(new State)
+{
+    m_state->file.open(path, std::ios::binary);
+    unsigned char header[headerSize];
+    if(!m_state->file.read(reinterpret_cast<char*>(header), headerSize))
+    {
+        return;
+    }
+    const auto width = loadBigEndian(header + 4);
+    const auto height = loadBigEndian(header + 8);
+    const int channels = header[12];
+    if(!std::equal(header, header + 4, "qoif") || width == 0 || height == 0 ||
+       static_cast<std::uint64_t>(width) * height > maxPixelCount || (channels != 3 && channels != 4) || header[13] > 1)
+    {
+        return;
+    }
+    m_state->width = static_cast<int>(width);
+    m_state->height = static_cast<int>(height);
+    m_state->channels = channels;
+    m_state->linear = header[13] == 1;
+    m_state->buffer.resize(64 * 1024);
+}
+
+QoiReader::~QoiReader() = default;
+
+bool QoiReader::isOpen() const
+{
+    return m_state->channels > 0;
+}
+
+int QoiReader::width() const
+{
+    return m_state->width;
+}
+
+int QoiReader::height() const
+{
+    return m_state->height;
+}
+
+int QoiReader::channels() const
+{
+    return m_state->channels;
+}
+
+bool QoiReader::isLinear() const
+{
+    return m_state->linear;
+}
+
+bool QoiReader::readRow(unsigned char* row)
+{
+    if(!isOpen() || m_state->readRows >= m_state->height)
+    {
+        return false;
+    }
+    auto& state = *m_state;
+    for(int column = 0; column < state.width; ++column, row += state.channels)
+    {
+        if(!state.decode())
+        {
+            return false;
+        }
+        row[0] = state.pixel.r;
+        row[1] = state.pixel.g;
+        row[2] = state.pixel.b;
+        if(state.channels == 4)
+        {
+            row[3] = state.pixel.a;
+        }
+    }
+    ++state.readRows;
+    return true;
+}
+
+bool decodeQoiImage(const std::string& path, Image& image, const ImageFormat pixelFormat)
+{
+    QoiReader reader(path);
+    const int channels = formatChannelCount(pixelFormat);
+    if(!reader.isOpen() || channels < 1)
+    {
+        return false;
+    }
+    Image decoded(reader.width(), reader.height());
+    std::vector<unsigned char> row(static_cast<std::size_t>(reader.width()) * reader.channels());
+    auto pixel = decoded.begin();
+    for(int y = 0; y < reader.height(); ++y)
+    {
+        if(!reader.readRow(row.data()))
+        {
+            return false;
+        }
+        for(std::size_t offset = 0; offset < row.size(); offset += reader.channels(), ++pixel)
+        {
+            const unsigned char alpha = reader.channels() == 4 ? row[offset + 3] : 255;
+            // Same luminance weights as stb_image
+            const auto luminance =
+              static_cast<unsigned char>((row[offset] * 77 + row[offset + 1] * 150 + row[offset + 2] * 29) >> 8);
+            switch(channels)
+            {
+                case 1: *pixel = Coloruc{luminance}; break;
+                case 2: *pixel = Color2uc{luminance, alpha}; break;
+                case 3: *pixel = Color3uc{row[offset], row[offset + 1], row[offset + 2]}; break;
+                default: *pixel = Color4uc{row[offset], row[offset + 1], row[offset + 2], alpha}; break;
+            }
+        }
+    }
+    image = std::move(decoded);
+    return true;
+}
+
+bool encodeQoiImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
+    const bool hasAlpha = pixelFormat == ImageSaveFormat::LUMA || pixelFormat == ImageSaveFormat::RGBA;
+    const bool isGray = pixelFormat == ImageSaveFormat::LUM || pixelFormat == ImageSaveFormat::LUMA;
+    const int channels = hasAlpha ? 4 : 3;
+    QoiWriter writer(path, image.width(), image.height(), channels);
+    if(!writer.isOpen())
+    {
+        return false;
+    }
+    const auto width = static_cast<std::size_t>(image.width());
+    std::vector<unsigned char> row(width * channels);
+    const bool toneMapped = !options.toneMapping.isClampOnly();
+    std::vector<Color4f> encodedRow(toneMapped || options.linearToSrgb ? width : 0);
+    for(int y = 0; y < image.height(); ++y)
+    {
+        const int sourceRow = options.flipVertically ? image.height() - 1 - y : y;
+        const Color4f* pixel = image.data() + static_cast<std::size_t>(sourceRow) * width;
+        if(toneMapped)
+        {
+            toneMap(pixel, encodedRow.data(), width, options.toneMapping, isGray ? 1 : 3);
+            pixel = encodedRow.data();
+        }
+        if(options.linearToSrgb)
+        {
+            linearToSrgb(pixel, encodedRow.data(), width, isGray ? 1 : 3);
+            pixel = encodedRow.data();
+        }
+        for(std::size_t offset = 0; offset < row.size(); offset += channels, ++pixel)
+        {
+            // Gray images store the luminance in the first channel and the alpha in the second one
+            row[offset] = toUnsignedChar(pixel->r());
+            row[offset + 1] = isGray ? row[offset] : toUnsignedChar(pixel->g());
+            row[offset + 2] = isGray ? row[offset] : toUnsignedChar(pixel->b());
+            if(hasAlpha)
+            {
+                row[offset + 3] = toUnsignedChar(isGray ? pixel->g() : pixel->a());
+            }
+        }
+        if(!writer.writeRow(row.data()))
+        {
+            return false;
+        }
+    }
+    return writer.close();
+}
+
+} // namespace stbipp
@@ -0,0 +1,462 @@
+#include "stbipp/RawImage.hpp"
+
+#include "BuiltinCodecs.hpp"
+#include "Checksum.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const char rawMagic[8] = {'S', 'T', 'B', 'I', 'P', 'R', 'A', 'W'};
+const std::uint32_t rawVersion = 1;
+const std::uint32_t byteOrderMark = 0x01020304;
+const std::size_t rawAlignment = 64;
+const std::size_t rawHeaderSize = 64;
+
+/**
+ * @brief Header of a raw stbipp file, stored field by field at these offsets in the byte order of the writer
+ */
+struct RawHeader
+{
+    char magic[8];              // 0
+    std::uint32_t version;      // 8
+    std::uint32_t byteOrder;    // 12
+    std::uint32_t width;        // 16
+    std::uint32_t height;       // 20
+    std::int32_t pixelFormat;   // 24
+    std::uint32_t checksum;     // 28, CRC-32 of the pixel data, padding included
+    std::uint64_t rowPitch;     // 32
+    std::uint64_t dataOffset;   // 40
+    std::uint64_t dataSize;     // 48
+    std::uint64_t reserved;     // 56
+};
+
+void serialize(const RawHeader& header, unsigned char* output)
+{
+    std::memset(output, 0, rawHeaderSize);
+    std::memcpy(output, header.magic, sizeof(header.magic));
+    std::memcpy(output + 8, &header.version, 4);
+    std::memcpy(output + 12, &header.byteOrder, 4);
+    std::memcpy(output + 16, &header.width, 4);
+    std::memcpy(output + 20, &header.height, 4);
+    std::memcpy(output + 24, &header.pixelFormat, 4);
+    std::memcpy(output + 28, &header.checksum, 4);
+    std::memcpy(output + 32, &header.rowPitch, 8);
+    std::memcpy(output + 40, &header.dataOffset, 8);
+    std::memcpy(output + 48, &header.dataSize, 8);
+}
+
+RawHeader deserialize(const unsigned char* input)
+{
+    RawHeader header{};
+    std::memcpy(header.magic, input, sizeof(header.magic));
+    std::memcpy(&header.version, input + 8, 4);
+    std::memcpy(&header.byteOrder, input + 12, 4);
+    std::memcpy(&header.width, input + 16, 4);
+    std::memcpy(&header.height, input + 20, 4);
+    std::memcpy(&header.pixelFormat, input + 24, 4);
+    std::memcpy(&header.checksum, input + 28, 4);
+    std::memcpy(&header.rowPitch, input + 32, 8);
+    std::memcpy(&header.dataOffset, input + 40, 8);
+    std::memcpy(&header.dataSize, input + 48, 8);
+    return header;
+}
+
+bool isValidFormat(stbipp::ImageFormat format)
+{
+    return stbipp::isFormat8Bits(format) || stbipp::isFormat16Bits(format) || stbipp::isFormat32Bits(format);
+}
+
+std::size_t pixelSize(stbipp::ImageFormat format)
+{
+    const std::size_t channelSize = stbipp::isFormat8Bits(format) ? 1 : stbipp::isFormat16Bits(format) ? 2 : 4;
+    return channelSize * static_cast<std::size_t>(stbipp::formatChannelCount(format));
+}
+
+template<class ColorType>
+bool writeRows(const stbipp::Image& image,
+               std::size_t rowPitch,
+               bool flipVertically,
+               std::ofstream& file,
+               std::uint32_t& checksum)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    std::vector<unsigned char> row(rowPitch, 0);
+    for(int y = 0; y < image.height(); ++y)
+    {
+        const int sourceRow = flipVertically ? image.height() - 1 - y : y;
+        const auto* source = image.data() + width * static_cast<std::size_t>(sourceRow);
+        convertPixels(source, reinterpret_cast<ColorType*>(row.data()), width);
+        checksum = stbipp::crc32(row.data(), row.size(), checksum);
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+template<class ColorType>
+void readRows(const stbipp::MappedImage& mapped, stbipp::Image& image)
+{
+    const auto width = static_cast<std::size_t>(mapped.width());
+    for(int y = 0; y < mapped.height(); ++y)
+    {
+        convertPixels(mapped.row<ColorType>(y), image.data() + width * static_cast<std::size_t>(y), width);
+    }
+}
+
+/**
+ * @brief Convert the channels of a pixel to the requested channel count as stb_image does, so a raw file loads like the
+ * other formats: the luminance uses the stb_image weights, gray is replicated to the color channels and a missing
+ * alpha is opaque
+ * @param[in] pixel The pixel read from the file
+ * @param[in] storedChannels Number of channels stored in the file
+ * @param[in] channels Number of channels requested
+ * @return The converted pixel, the channels after the requested ones are 0
+ */
+stbipp::Color4f convertChannels(const stbipp::Color4f& pixel, int storedChannels, int channels)
+{
+    const bool storedColor = storedChannels >= 3;
+    const float alpha = storedChannels == 2 || storedChannels == 4 ? pixel[storedChannels - 1] : 1.0f;
+    const float luminance = storedColor ? (77.0f * pixel[0] + 150.0f * pixel[1] + 29.0f * pixel[2]) / 256.0f : pixel[0];
+    switch(channels)
+    {
+        case 1: return stbipp::Color4f(luminance, 0.0f, 0.0f, 0.0f);
+        case 2: return stbipp::Color4f(luminance, alpha, 0.0f, 0.0f);
+        case 3:
+            return storedColor ? stbipp::Color4f(pixel[0], pixel[1], pixel[2], 0.0f) :
+                                 stbipp::Color4f(luminance, luminance, luminance, 0.0f);
+        default:
+            return storedColor ? stbipp::Color4f(pixel[0], pixel[1], pixel[2], alpha) :
+                                 stbipp::Color4f(luminance, luminance, luminance, alpha);
+    }
+}
+
+/**
+ * @brief Write a raw stbipp file, see saveRaw
+ * @param[in] flipVertically Store the rows from bottom to top
+ */
+bool writeRaw(const std::string& path,
+              const stbipp::Image& image,
+              const stbipp::ImageFormat pixelFormat,
+              bool flipVertically)
+{
+    using namespace stbipp;
+
+    if(!isValidFormat(pixelFormat))
+    {
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+
+    RawHeader header{};
+    std::copy(std::begin(rawMagic), std::end(rawMagic), header.magic);
+    header.version = rawVersion;
+    header.byteOrder = byteOrderMark;
+    header.width = static_cast<std::uint32_t>(image.width());
+    header.height = static_cast<std::uint32_t>(image.height());
+    header.pixelFormat = static_cast<std::int32_t>(pixelFormat);
+    const std::size_t rowSize = pixelSize(pixelFormat) * static_cast<std::size_t>(image.width());
+    header.rowPitch = (rowSize + rawAlignment - 1) / rawAlignment * rawAlignment;
+    header.dataOffset = rawHeaderSize;
+    header.dataSize = header.rowPitch * header.height;
+
+    // The checksum is only known once the pixels are written, the header is written again at the end
+    unsigned char serialized[rawHeaderSize];
+    serialize(header, serialized);
+    file.write(reinterpret_cast<const char*>(serialized), rawHeaderSize);
+
+    const std::size_t rowPitch = static_cast<std::size_t>(header.rowPitch);
+    std::uint32_t checksum = 0;
+    bool written = false;
+    switch(pixelFormat)
+    {
+        case ImageFormat::LUM8: written = writeRows<Coloruc>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::LUMA8: written = writeRows<Color2uc>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGB8: written = writeRows<Color3uc>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGBA8: written = writeRows<Color4uc>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::LUM16: written = writeRows<Colorus>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::LUMA16: written = writeRows<Color2us>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGB16: written = writeRows<Color3us>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGBA16: written = writeRows<Color4us>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::LUM32: written = writeRows<Colorf>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::LUMA32: written = writeRows<Color2f>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGB32: written = writeRows<Color3f>(image, rowPitch, flipVertically, file, checksum); break;
+        case ImageFormat::RGBA32: written = writeRows<Color4f>(image, rowPitch, flipVertically, file, checksum); break;
+        default: break;
+    }
+    if(!written)
+    {
+        return false;
+    }
+
+    header.checksum = checksum;
+    serialize(header, serialized);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(serialized), rawHeaderSize);
+    file.close();
+    return !file.fail();
+}
+
+} // namespace
+
+namespace stbipp
+{
+struct MappedImage::Mapping
+{
+    const unsigned char* address{nullptr};
+    std::size_t size{0};
+#ifdef _WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE fileMapping{nullptr};
+#endif
+    int width{0};
+    int height{0};
+    ImageFormat pixelFormat{ImageFormat::UNDEFINED};
+    std::size_t rowPitch{0};
+    std::size_t dataOffset{0};
+
+    bool map(const std::string& path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(
+          path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            return false;
+        }
+        fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(fileMapping == nullptr)
+        {
+            return false;
+        }
+        address = static_cast<const unsigned char*>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0));
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+        return address != nullptr;
+#else
+        const int descriptor = open(path.c_str(), O_RDONLY);
+        if(descriptor < 0)
+        {
+            return false;
+        }
+        struct stat status;
+        if(fstat(descriptor, &status) != 0 || status.st_size <= 0)
+        {
+            close(descriptor);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+        // The mapping keeps its own reference to the file
+        close(descriptor);
+        if(mapped == MAP_FAILED)
+        {
+            return false;
+        }
+        address = static_cast<const unsigned char*>(mapped);
+        size = static_cast<std::size_t>(status.st_size);
+        return true;
+#endif
+    }
+
+    ~Mapping()
+    {
+#ifdef _WIN32
+        if(address)
+        {
+            UnmapViewOfFile(address);
+        }
+        if(fileMapping)
+        {
+            CloseHandle(fileMapping);
+        }
+        if(file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+#else
+        if(address)
+        {
+            munmap(const_cast<unsigned char*>(address), size);
+        }
+#endif
+    }
+};
+
+MappedImage::MappedImage() = default;
+
+MappedImage::~MappedImage() = default;
+
+MappedImage::MappedImage(MappedImage&& other) noexcept: m_mapping(std::move(other.m_mapping)) {}
+
+MappedImage& MappedImage::operator=(MappedImage&& other) noexcept
+{
+    m_mapping = std::move(other.m_mapping);
+    return *this;
+}
+
+bool MappedImage::isValid() const
+{
+    return m_mapping != nullptr;
+}
+
+int MappedImage::width() const
+{
+    return m_mapping ? m_mapping->width : 0;
+}
+
+int MappedImage::height() const
+{
+    return m_mapping ? m_mapping->height : 0;
+}
+
+ImageFormat MappedImage::pixelFormat() const
+{
+    return m_mapping ? m_mapping->pixelFormat : ImageFormat::UNDEFINED;
+}
+
+std::size_t MappedImage::rowPitch() const
+{
+    return m_mapping ? m_mapping->rowPitch : 0;
+}
+
+const void* MappedImage::rowData(int row) const
+{
+    if(!m_mapping || row < 0 || row >= m_mapping->height)
+    {
+        throw std::out_of_range("Trying to access out of range value");
+    }
+    return m_mapping->address + m_mapping->dataOffset + static_cast<std::size_t>(row) * m_mapping->rowPitch;
+}
+
+Image MappedImage::toImage() const
+{
+    Image image(width(), height());
+    switch(pixelFormat())
+    {
+        case ImageFormat::LUM8: readRows<Coloruc>(*this, image); break;
+        case ImageFormat::LUMA8: readRows<Color2uc>(*this, image); break;
+        case ImageFormat::RGB8: readRows<Color3uc>(*this, image); break;
+        case ImageFormat::RGBA8: readRows<Color4uc>(*this, image); break;
+        case ImageFormat::LUM16: readRows<Colorus>(*this, image); break;
+        case ImageFormat::LUMA16: readRows<Color2us>(*this, image); break;
+        case ImageFormat::RGB16: readRows<Color3us>(*this, image); break;
+        case ImageFormat::RGBA16: readRows<Color4us>(*this, image); break;
+        case ImageFormat::LUM32: readRows<Colorf>(*this, image); break;
+        case ImageFormat::LUMA32: readRows<Color2f>(*this, image); break;
+        case ImageFormat::RGB32: readRows<Color3f>(*this, image); break;
+        case ImageFormat::RGBA32: readRows<Color4f>(*this, image); break;
+        default: break;
+    }
+    return image;
+}
+
+bool saveRaw(const std::string& path, const Image& image, const ImageFormat pixelFormat)
+{
+    return writeRaw(path, image, pixelFormat, false);
+}
+
+bool loadRaw(const std::string& path, MappedImage& image, bool verifyChecksum)
+{
+    image = MappedImage();
+    std::unique_ptr<MappedImage::Mapping> mapping(new MappedImage::Mapping);
+    if(!mapping->map(path) || mapping->size < rawHeaderSize)
+    {
+        return false;
+    }
+
+    const RawHeader header = deserialize(mapping->address);
+    const auto format = static_cast<ImageFormat>(header.pixelFormat);
+    if(!std::equal(std::begin(rawMagic), std::end(rawMagic), header.magic) || header.version != rawVersion ||
+       header.byteOrder != byteOrderMark || !isValidFormat(format) || header.dataOffset < rawHeaderSize ||
+       header.dataOffset % rawAlignment != 0 || header.dataOffset > mapping->size ||
+       header.width > static_cast<std::uint32_t>(std::numeric_limits<int>::max()) ||
+       header.height > static_cast<std::uint32_t>(std::numeric_limits<int>::max()) ||
+       header.rowPitch < pixelSize(format) * header.width)
+    {
+        return false;
+    }
+    const std::uint64_t availableSize = mapping->size - header.dataOffset;
+    if(header.height > 0 && header.rowPitch > availableSize / header.height)
+    {
+        return false;
+    }
+    const std::size_t dataSize = static_cast<std::size_t>(header.rowPitch * header.height);
+    if(verifyChecksum && crc32(mapping->address + header.dataOffset, dataSize) != header.checksum)
+    {
+        return false;
+    }
+
+    mapping->width = static_cast<int>(header.width);
+    mapping->height = static_cast<int>(header.height);
+    mapping->pixelFormat = format;
+    mapping->rowPitch = static_cast<std::size_t>(header.rowPitch);
+    mapping->dataOffset = static_cast<std::size_t>(header.dataOffset);
+    image.m_mapping = std::move(mapping);
+    return true;
+}
+
+bool decodeRawImage(const std::string& path, Image& image, const ImageFormat pixelFormat)
+{
+    MappedImage mapped;
+    if(!loadRaw(path, mapped))
+    {
+        return false;
+    }
+    image = mapped.toImage();
+    // The stored precision is kept, only the channels are converted to the requested format
+    const int channels = formatChannelCount(pixelFormat);
+    const int storedChannels = formatChannelCount(mapped.pixelFormat());
+    if(channels > 0 && channels != storedChannels)
+    {
+        for(auto& pixel: image)
+        {
+            pixel = convertChannels(pixel, storedChannels, channels);
+        }
+    }
+    return true;
+}
+
+bool encodeRawImage(const std::string& path,
+                    const Image& image,
+                    const ImageSaveFormat pixelFormat,
+                    const SaveOptions& options)
+{
+    static const ImageFormat floatFormats[] = {
+      ImageFormat::LUM32, ImageFormat::LUMA32, ImageFormat::RGB32, ImageFormat::RGBA32};
+    const int channels = formatChannelCount(pixelFormat);
+    if(channels < 1)
+    {
+        return false;
+    }
+    return writeRaw(path, image, floatFormats[channels - 1], options.flipVertically);
+}
+
+} // namespace stbipp
@@ -0,0 +1,321 @@
+#include "stbipp/Resample.hpp"
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// Number of floats filtered by each task of the multithreaded passes
+constexpr std::size_t grainSize = 65536;
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief The source pixels contributing to a resampled pixel
+ */
+struct Contribution
+{
+    int first{0};          /// Index of the first source pixel
+    int count{0};          /// Number of source pixels
+    std::size_t offset{0}; /// Index of the first weight in the table
+};
+
+/**
+ * @brief Filter weights of every resampled pixel along one axis
+ */
+struct WeightTable
+{
+    std::vector<Contribution> contributions;
+    std::vector<float> weights;
+};
+
+double filterSupport(stbipp::ResampleFilter filter)
+{
+    using stbipp::ResampleFilter;
+
+    switch(filter)
+    {
+        case ResampleFilter::BOX: return 0.5;
+        case ResampleFilter::BILINEAR: return 1.0;
+        case ResampleFilter::BICUBIC:
+        case ResampleFilter::MITCHELL: return 2.0;
+        case ResampleFilter::LANCZOS3: return 3.0;
+    }
+    return 1.0;
+}
+
+/**
+ * @brief Mitchell-Netravali cubic family, B = 0 and C = 0.5 gives Catmull-Rom
+ */
+double cubic(double x, double b, double c)
+{
+    x = std::fabs(x);
+    if(x < 1.0)
+    {
+        return ((12.0 - 9.0 * b - 6.0 * c) * x * x * x + (-18.0 + 12.0 * b + 6.0 * c) * x * x + (6.0 - 2.0 * b)) /
+               6.0;
+    }
+    if(x < 2.0)
+    {
+        return ((-b - 6.0 * c) * x * x * x + (6.0 * b + 30.0 * c) * x * x + (-12.0 * b - 48.0 * c) * x +
+                (8.0 * b + 24.0 * c)) /
+               6.0;
+    }
+    return 0.0;
+}
+
+double sinc(double x)
+{
+    if(std::fabs(x) < 1e-8)
+    {
+        return 1.0;
+    }
+    return std::sin(pi * x) / (pi * x);
+}
+
+double filterWeight(stbipp::ResampleFilter filter, double x)
+{
+    using stbipp::ResampleFilter;
+
+    switch(filter)
+    {
+        case ResampleFilter::BOX: return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+        case ResampleFilter::BILINEAR: return std::max(0.0, 1.0 - std::fabs(x));
+        case ResampleFilter::BICUBIC: return cubic(x, 0.0, 0.5);
+        case ResampleFilter::MITCHELL: return cubic(x, 1.0 / 3.0, 1.0 / 3.0);
+        case ResampleFilter::LANCZOS3: return std::fabs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Compute the normalized weights of the source pixels for each resampled pixel
+ * The weights of the pixels outside the source are given to the border pixels.
+ * @param[in] sourceSize Number of source pixels
+ * @param[in] size Number of resampled pixels
+ * @param[in] filter The resampling filter
+ * @return The weight table
+ */
+WeightTable computeWeights(int sourceSize, int size, stbipp::ResampleFilter filter)
+{
+    WeightTable table;
+    table.contributions.resize(static_cast<std::size_t>(size));
+    const double scale = static_cast<double>(sourceSize) / static_cast<double>(size);
+    // The filter is stretched when downscaling so it covers all the source pixels
+    const double filterScale = std::max(scale, 1.0);
+    const double support = filterSupport(filter) * filterScale;
+    std::vector<double> weights;
+    for(int index = 0; index < size; ++index)
+    {
+        const double center = (static_cast<double>(index) + 0.5) * scale;
+        const int left = static_cast<int>(std::floor(center - support));
+        const int right = static_cast<int>(std::ceil(center + support));
+        const int first = std::max(left, 0);
+        const int last = std::min(right, sourceSize - 1);
+        weights.assign(static_cast<std::size_t>(last - first + 1), 0.0);
+        double sum = 0.0;
+        for(int sourceIndex = left; sourceIndex <= right; ++sourceIndex)
+        {
+            const double weight = filterWeight(filter, (static_cast<double>(sourceIndex) + 0.5 - center) / filterScale);
+            const int clamped = std::min(std::max(sourceIndex, first), last);
+            weights[static_cast<std::size_t>(clamped - first)] += weight;
+            sum += weight;
+        }
+
+        // Skip the pixels without contribution at both ends
+        std::size_t begin = 0;
+        std::size_t end = weights.size();
+        while(begin + 1 < end && weights[begin] == 0.0)
+        {
+            ++begin;
+        }
+        while(end > begin + 1 && weights[end - 1] == 0.0)
+        {
+            --end;
+        }
+
+        auto& contribution = table.contributions[static_cast<std::size_t>(index)];
+        contribution.first = first + static_cast<int>(begin);
+        contribution.count = static_cast<int>(end - begin);
+        contribution.offset = table.weights.size();
+        // The weights always sum to 1, a filter without contribution averages the pixels
+        const double fallbackWeight = 1.0 / static_cast<double>(end - begin);
+        for(std::size_t weightIndex = begin; weightIndex < end; ++weightIndex)
+        {
+            table.weights.push_back(static_cast<float>(sum != 0.0 ? weights[weightIndex] / sum : fallbackWeight));
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Sum of source colors weighted by the given weights
+ */
+stbipp::Color4f weightedSum(const stbipp::Color4f* source, const float* weights, int count)
+{
+    stbipp::Color4f result;
+#if defined(STBIPP_SIMD_SSE2)
+    __m128 sum = _mm_setzero_ps();
+    for(int index = 0; index < count; ++index)
+    {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source[index].data()), _mm_set1_ps(weights[index])));
+    }
+    _mm_storeu_ps(result.data(), sum);
+#else
+    float sum[4]{};
+    for(int index = 0; index < count; ++index)
+    {
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            sum[channel] += source[index][channel] * weights[index];
+        }
+    }
+    result = stbipp::Color4f(sum[0], sum[1], sum[2], sum[3]);
+#endif
+    return result;
+}
+
+/**
+ * @brief Add a row of colors multiplied by a weight to another row
+ */
+void addWeightedRow(const stbipp::Color4f* source, float weight, stbipp::Color4f* destination, std::size_t count)
+{
+    const float* input = source->data();
+    float* output = destination->data();
+    const std::size_t size = count * 4;
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 factor = _mm_set1_ps(weight);
+    for(std::size_t index = 0; index < size; index += 4)
+    {
+        _mm_storeu_ps(output + index,
+                      _mm_add_ps(_mm_loadu_ps(output + index), _mm_mul_ps(_mm_loadu_ps(input + index), factor)));
+    }
+#else
+    for(std::size_t index = 0; index < size; ++index)
+    {
+        output[index] += input[index] * weight;
+    }
+#endif
+}
+
+std::size_t rowsPerTask(int width)
+{
+    return std::max<std::size_t>(1, grainSize / (static_cast<std::size_t>(std::max(width, 1)) * 4));
+}
+
+} // namespace
+
+namespace stbipp
+{
+namespace detail
+{
+void resampleRows(int sourceWidth,
+                  int sourceHeight,
+                  int width,
+                  int height,
+                  ResampleFilter filter,
+                  unsigned int threadCount,
+                  const ResampleRowReader& reader,
+                  const ResampleRowWriter& writer)
+{
+    if(width < 0 || height < 0)
+    {
+        throw std::invalid_argument("New image dimensions must be positive integers!");
+    }
+    if(width == 0 || height == 0)
+    {
+        return;
+    }
+    if(sourceWidth <= 0 || sourceHeight <= 0)
+    {
+        throw std::invalid_argument("Can't resample an empty image");
+    }
+
+    const WeightTable horizontal = computeWeights(sourceWidth, width, filter);
+    const WeightTable vertical = computeWeights(sourceHeight, height, filter);
+    const auto resultWidth = static_cast<std::size_t>(width);
+
+    // Horizontal pass, only the source rows used by the vertical pass are resampled
+    int firstRow = sourceHeight;
+    int lastRow = 0;
+    for(const auto& contribution: vertical.contributions)
+    {
+        firstRow = std::min(firstRow, contribution.first);
+        lastRow = std::max(lastRow, contribution.first + contribution.count);
+    }
+    std::vector<Color4f> intermediate(static_cast<std::size_t>(lastRow - firstRow) * resultWidth);
+    parallelFor(
+      static_cast<std::size_t>(firstRow),
+      static_cast<std::size_t>(lastRow),
+      rowsPerTask(sourceWidth),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<Color4f> buffer(static_cast<std::size_t>(sourceWidth));
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              const Color4f* source = reader(static_cast<int>(row), buffer.data());
+              Color4f* destination = intermediate.data() + (row - static_cast<std::size_t>(firstRow)) * resultWidth;
+              for(std::size_t column = 0; column < resultWidth; ++column)
+              {
+                  const auto& contribution = horizontal.contributions[column];
+                  destination[column] = weightedSum(source + contribution.first,
+                                                    horizontal.weights.data() + contribution.offset,
+                                                    contribution.count);
+              }
+          }
+      },
+      threadCount);
+
+    // Vertical pass
+    parallelFor(
+      0,
+      static_cast<std::size_t>(height),
+      rowsPerTask(width),
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<Color4f> buffer(resultWidth);
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              const auto& contribution = vertical.contributions[row];
+              fillPixels(buffer.data(), buffer.size(), Color4f{0.0f});
+              for(int index = 0; index < contribution.count; ++index)
+              {
+                  const auto sourceRow = static_cast<std::size_t>(contribution.first + index - firstRow);
+                  addWeightedRow(intermediate.data() + sourceRow * resultWidth,
+                                 vertical.weights[contribution.offset + static_cast<std::size_t>(index)],
+                                 buffer.data(),
+                                 resultWidth);
+              }
+              writer(static_cast<int>(row), buffer.data());
+          }
+      },
+      threadCount);
+}
+} // namespace detail
+
+Image resample(const Image& image, int width, int height, ResampleFilter filter, unsigned int threadCount)
+{
+    if(width < 0 || height < 0)
+    {
+        throw std::invalid_argument("New image dimensions must be positive integers!");
+    }
+    Image result(width, height);
+    const auto sourceWidth = static_cast<std::size_t>(image.width());
+    const auto resultWidth = static_cast<std::size_t>(width);
+    detail::resampleRows(
+      image.width(),
+      image.height(),
+      width,
+      height,
+      filter,
+      threadCount,
+      [&image, sourceWidth](int row, Color4f*) { return image.data() + sourceWidth * static_cast<std::size_t>(row); },
+      [&result, resultWidth](int row, const Color4f* colors) {
+          copyPixels(colors, result.data() + resultWidth * static_cast<std::size_t>(row), resultWidth);
+      });
+    return result;
+}
+
+} // namespace stbipp
@@ -0,0 +1,77 @@
+#include "stbipp/Sampling.hpp"
+
+#include "Interpolation.hpp"
+#include "stbipp/Parallel.hpp"
+
+namespace
+{
+// Number of points sampled by each task of the thread pool
+constexpr std::size_t grainSize = 4096;
+
+/**
+ * @brief Interpolate an image at a range of positions, the sampling of each position is inlined in the loop
+ */
+template<int tapCount>
+void sampleRange(const stbipp::Image& image,
+                 const stbipp::Point2f* points,
+                 std::size_t count,
+                 stbipp::Color4f* colors,
+                 const stbipp::SampleOptions& options)
+{
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const stbipp::Point2f point = points[index];
+        colors[index] =
+          stbipp::detail::samplePoint<tapCount>(image, point.x, point.y, options.border, options.borderColor);
+    }
+}
+
+} // namespace
+
+namespace stbipp
+{
+Color4f sample(const Image& image, float x, float y, SampleFilter filter, BorderMode border, const Color4f& borderColor)
+{
+    if(image.width() <= 0 || image.height() <= 0)
+    {
+        return borderColor;
+    }
+    switch(filter)
+    {
+        case SampleFilter::NEAREST: return detail::samplePoint<1>(image, x, y, border, borderColor);
+        case SampleFilter::BILINEAR: return detail::samplePoint<2>(image, x, y, border, borderColor);
+        case SampleFilter::BICUBIC: return detail::samplePoint<4>(image, x, y, border, borderColor);
+    }
+    return borderColor;
+}
+
+void sampleMany(const Image& image,
+                const Point2f* points,
+                std::size_t count,
+                Color4f* colors,
+                const SampleOptions& options)
+{
+    if(image.width() <= 0 || image.height() <= 0)
+    {
+        fillPixels(colors, count, options.borderColor);
+        return;
+    }
+    parallelFor(
+      0,
+      count,
+      grainSize,
+      [&](std::size_t begin, std::size_t end) {
+          const Point2f* first = points + begin;
+          Color4f* output = colors + begin;
+          const std::size_t chunkSize = end - begin;
+          switch(options.filter)
+          {
+              case SampleFilter::NEAREST: sampleRange<1>(image, first, chunkSize, output, options); break;
+              case SampleFilter::BILINEAR: sampleRange<2>(image, first, chunkSize, output, options); break;
+              case SampleFilter::BICUBIC: sampleRange<4>(image, first, chunkSize, output, options); break;
+          }
+      },
+      options.threadCount);
+}
+
+} // namespace stbipp
@@ -0,0 +1,172 @@
+#include "stbipp/Srgb.hpp"
+
+#include "FastMath.hpp"
+#include "stbipp/ChannelConversion.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+// Number of pixels converted by each task of the multithreaded image conversions
+constexpr std::size_t grainSize = 16384;
+
+/**
+ * @brief Table of the linear values of the sRGB integers [0, size - 1]
+ */
+template<std::size_t size>
+struct SrgbTable
+{
+    SrgbTable()
+    {
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            const double value = static_cast<double>(index) / static_cast<double>(size - 1);
+            const double linear = value > 0.04045 ? std::pow((value + 0.055) / 1.055, 2.4) : value / 12.92;
+            values[index] = static_cast<float>(linear);
+        }
+    }
+
+    float values[size];
+};
+
+const float* srgb8Table()
+{
+    static const SrgbTable<256> table;
+    return table.values;
+}
+
+const float* srgb16Table()
+{
+    static const SrgbTable<65536> table;
+    return table.values;
+}
+
+
+template<class DataType>
+void decodeSrgb(const DataType* source,
+                int channels,
+                stbipp::Color4f* destination,
+                std::size_t count,
+                const float* colorTable,
+                const float* alphaTable)
+{
+    const bool hasAlpha = channels == 2 || channels == 4;
+    const int colorChannels = hasAlpha ? channels - 1 : channels;
+    for(std::size_t pixel = 0; pixel < count; ++pixel, source += channels)
+    {
+        float* output = destination[pixel].data();
+        int channel = 0;
+        for(; channel < colorChannels; ++channel)
+        {
+            output[channel] = colorTable[source[channel]];
+        }
+        if(hasAlpha)
+        {
+            output[channel] = alphaTable[source[channel]];
+            ++channel;
+        }
+        for(; channel < 4; ++channel)
+        {
+            output[channel] = 0.0f;
+        }
+    }
+}
+
+} // namespace
+
+namespace stbipp
+{
+void srgbToLinear(const unsigned char* source, int channels, Color4f* destination, std::size_t count)
+{
+    decodeSrgb(source, channels, destination, count, srgb8Table(), detail::unorm8Table());
+}
+
+void srgbToLinear(const unsigned short* source, int channels, Color4f* destination, std::size_t count)
+{
+    decodeSrgb(source, channels, destination, count, srgb16Table(), detail::unorm16Table());
+}
+
+void srgbToLinear(const Color4f* source, Color4f* destination, std::size_t count, unsigned int colorChannels)
+{
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 copied = detail::copiedChannelsMask(colorChannels);
+    const __m128 threshold = _mm_set1_ps(0.04045f);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const __m128 value = _mm_loadu_ps(source[index].data());
+        const __m128 curve =
+          detail::powApprox(_mm_mul_ps(_mm_add_ps(value, _mm_set1_ps(0.055f)), _mm_set1_ps(1.0f / 1.055f)), 2.4f);
+        // NaN fails the comparison and goes through the linear segment
+        const __m128 segment = _mm_mul_ps(value, _mm_set1_ps(1.0f / 12.92f));
+        const __m128 linear = detail::select(_mm_cmpgt_ps(value, threshold), curve, segment);
+        _mm_storeu_ps(destination[index].data(), detail::select(copied, value, linear));
+    }
+#else
+    // A scalar approximation is not faster than std::pow, the exact transfer function is used
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const Color4f value = source[index];
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            destination[index][channel] = channel < colorChannels ? srgbToLinear(value[channel]) : value[channel];
+        }
+    }
+#endif
+}
+
+void linearToSrgb(const Color4f* source, Color4f* destination, std::size_t count, unsigned int colorChannels)
+{
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 copied = detail::copiedChannelsMask(colorChannels);
+    const __m128 threshold = _mm_set1_ps(0.0031308f);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const __m128 value = _mm_loadu_ps(source[index].data());
+        const __m128 curve =
+          _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.055f), detail::powApprox(value, 1.0f / 2.4f)), _mm_set1_ps(0.055f));
+        // NaN fails the comparison and goes through the linear segment
+        const __m128 segment = _mm_mul_ps(value, _mm_set1_ps(12.92f));
+        const __m128 srgb = detail::select(_mm_cmpgt_ps(value, threshold), curve, segment);
+        _mm_storeu_ps(destination[index].data(), detail::select(copied, value, srgb));
+    }
+#else
+    // A scalar approximation is not faster than std::pow, the exact transfer function is used
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const Color4f value = source[index];
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            destination[index][channel] = channel < colorChannels ? linearToSrgb(value[channel]) : value[channel];
+        }
+    }
+#endif
+}
+
+void srgbToLinear(Image& image, unsigned int threadCount)
+{
+    Color4f* pixels = image.data();
+    const auto count = static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height());
+    parallelFor(
+      0,
+      count,
+      grainSize,
+      [pixels](std::size_t begin, std::size_t end) { srgbToLinear(pixels + begin, pixels + begin, end - begin); },
+      threadCount);
+}
+
+void linearToSrgb(Image& image, unsigned int threadCount)
+{
+    Color4f* pixels = image.data();
+    const auto count = static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height());
+    parallelFor(
+      0,
+      count,
+      grainSize,
+      [pixels](std::size_t begin, std::size_t end) { linearToSrgb(pixels + begin, pixels + begin, end - begin); },
+      threadCount);
+}
+
+} // namespace stbipp
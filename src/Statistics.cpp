@@ -0,0 +1,252 @@
+#include "stbipp/Statistics.hpp"
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+// Number of pixels reduced by each task of the thread pool
+constexpr std::size_t grainSize = 65536;
+// Number of pixels reduced in single precision before being merged in double precision
+constexpr std::size_t blockSize = 256;
+
+/**
+ * @brief Partial statistics of a range of pixels
+ */
+struct Moments
+{
+    std::size_t count{0};
+    double mean[4]{};
+    // Sum of the squared differences to the mean
+    double squaredDeviations[4]{};
+    stbipp::Color4f minimum{};
+    stbipp::Color4f maximum{};
+
+    /**
+     * @brief Merge the statistics of another range with the parallel variance formula (Chan et al.)
+     */
+    void merge(const Moments& other)
+    {
+        if(other.count == 0)
+        {
+            return;
+        }
+        if(count == 0)
+        {
+            *this = other;
+            return;
+        }
+        const double total = static_cast<double>(count + other.count);
+        const double weight = static_cast<double>(count) * static_cast<double>(other.count) / total;
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            const double delta = other.mean[channel] - mean[channel];
+            mean[channel] += delta * static_cast<double>(other.count) / total;
+            squaredDeviations[channel] += other.squaredDeviations[channel] + delta * delta * weight;
+        }
+        count += other.count;
+        minimum = stbipp::minimum(minimum, other.minimum);
+        maximum = stbipp::maximum(maximum, other.maximum);
+    }
+};
+
+/**
+ * @brief Compute the statistics of a block of pixels with two passes over the colors, which stay in the cache
+ * The values are summed relatively to the first pixel so large values with a small spread keep their precision.
+ */
+Moments blockMoments(const stbipp::Color4f* colors, std::size_t count)
+{
+    Moments moments;
+    moments.count = count;
+    moments.minimum = colors[0];
+    moments.maximum = colors[0];
+    const stbipp::Color4f pivot = colors[0];
+    stbipp::Color4f sum{};
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        sum += colors[index] - pivot;
+        moments.minimum = stbipp::minimum(moments.minimum, colors[index]);
+        moments.maximum = stbipp::maximum(moments.maximum, colors[index]);
+    }
+    const stbipp::Color4f offset = sum / static_cast<float>(count);
+    stbipp::Color4f squaredDeviations{};
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const stbipp::Color4f deviation = colors[index] - pivot - offset;
+        squaredDeviations += deviation * deviation;
+    }
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        moments.mean[channel] = static_cast<double>(pivot[channel]) + offset[channel];
+        moments.squaredDeviations[channel] = squaredDeviations[channel];
+    }
+    return moments;
+}
+
+/**
+ * @brief Count the values of a range of pixels
+ * @param[in] colors The pixels
+ * @param[in] count Number of pixels
+ * @param[in] histogram Range and number of bins
+ * @param[out] counts binCount counters for each channel, one channel after the other
+ */
+void countValues(const stbipp::Color4f* colors,
+                 std::size_t count,
+                 const stbipp::Histogram& histogram,
+                 std::uint64_t* counts)
+{
+    const auto binCount = static_cast<std::size_t>(histogram.binCount);
+    const float scale = static_cast<float>(histogram.binCount) / (histogram.maximum - histogram.minimum);
+    const float lastBin = static_cast<float>(histogram.binCount - 1);
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 minimum = _mm_set1_ps(histogram.minimum);
+    const __m128 scaleFactor = _mm_set1_ps(scale);
+    const __m128 upper = _mm_set1_ps(lastBin);
+    alignas(16) std::int32_t bins[4];
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const __m128 scaled = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(colors[index].data()), minimum), scaleFactor);
+        // _mm_max_ps returns its second operand for NaN values, they land in the first bin
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), upper);
+        _mm_store_si128(reinterpret_cast<__m128i*>(bins), _mm_cvttps_epi32(clamped));
+        ++counts[static_cast<std::size_t>(bins[0])];
+        ++counts[binCount + static_cast<std::size_t>(bins[1])];
+        ++counts[2 * binCount + static_cast<std::size_t>(bins[2])];
+        ++counts[3 * binCount + static_cast<std::size_t>(bins[3])];
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            const float scaled = (colors[index][channel] - histogram.minimum) * scale;
+            const float clamped = scaled > 0.0f ? std::min(scaled, lastBin) : 0.0f;
+            ++counts[channel * binCount + static_cast<std::size_t>(clamped)];
+        }
+    }
+#endif
+}
+
+} // namespace
+
+namespace stbipp
+{
+ImageStatistics computeStatistics(const Image& image, unsigned int threadCount)
+{
+    ImageStatistics statistics;
+    const std::size_t pixelCount = static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height());
+    if(pixelCount == 0)
+    {
+        return statistics;
+    }
+
+    // Each chunk has its own partial result, merged in order so the result does not depend on the scheduling
+    std::vector<Moments> partials((pixelCount + grainSize - 1) / grainSize);
+    const Color4f* pixels = image.data();
+    parallelFor(
+      0,
+      pixelCount,
+      grainSize,
+      [&partials, pixels](std::size_t begin, std::size_t end) {
+          Moments& moments = partials[begin / grainSize];
+          for(std::size_t block = begin; block < end; block += blockSize)
+          {
+              moments.merge(blockMoments(pixels + block, std::min(blockSize, end - block)));
+          }
+      },
+      threadCount);
+
+    Moments total;
+    for(const auto& partial: partials)
+    {
+        total.merge(partial);
+    }
+    statistics.pixelCount = total.count;
+    statistics.minimum = total.minimum;
+    statistics.maximum = total.maximum;
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        const double count = static_cast<double>(total.count);
+        statistics.sum[channel] = static_cast<float>(total.mean[channel] * count);
+        statistics.mean[channel] = static_cast<float>(total.mean[channel]);
+        statistics.variance[channel] = static_cast<float>(total.squaredDeviations[channel] / count);
+    }
+    return statistics;
+}
+
+Histogram computeHistogram(const Image& image, int binCount, float minimum, float maximum, unsigned int threadCount)
+{
+    if(binCount <= 0 || !(maximum > minimum))
+    {
+        throw std::invalid_argument("A histogram needs at least one bin and a non empty range");
+    }
+    Histogram histogram;
+    histogram.minimum = minimum;
+    histogram.maximum = maximum;
+    histogram.binCount = binCount;
+    const auto bins = static_cast<std::size_t>(binCount);
+    for(auto& counts: histogram.counts)
+    {
+        counts.assign(bins, 0);
+    }
+
+    std::mutex mutex;
+    const Color4f* pixels = image.data();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height()),
+      grainSize,
+      [&](std::size_t begin, std::size_t end) {
+          std::vector<std::uint64_t> counts(4 * bins, 0);
+          countValues(pixels + begin, end - begin, histogram, counts.data());
+          std::lock_guard<std::mutex> lock(mutex);
+          for(std::size_t channel = 0; channel < 4; ++channel)
+          {
+              for(std::size_t bin = 0; bin < bins; ++bin)
+              {
+                  histogram.counts[channel][bin] += counts[channel * bins + bin];
+              }
+          }
+      },
+      threadCount);
+    return histogram;
+}
+
+Color4f estimatePercentile(const Histogram& histogram, float fraction)
+{
+    if(histogram.binCount <= 0 || !(fraction >= 0.0f && fraction <= 1.0f))
+    {
+        throw std::invalid_argument("A percentile needs a histogram with bins and a fraction in [0, 1]");
+    }
+    const double binWidth =
+      (static_cast<double>(histogram.maximum) - histogram.minimum) / static_cast<double>(histogram.binCount);
+    Color4f result(histogram.minimum);
+    for(unsigned int channel = 0; channel < 4; ++channel)
+    {
+        const auto& counts = histogram.counts[channel];
+        std::uint64_t total = 0;
+        for(const auto count: counts)
+        {
+            total += count;
+        }
+        const double target = static_cast<double>(fraction) * static_cast<double>(total);
+        double cumulated = 0.0;
+        for(std::size_t bin = 0; bin < counts.size(); ++bin)
+        {
+            const auto count = static_cast<double>(counts[bin]);
+            if(count > 0.0 && cumulated + count >= target)
+            {
+                const double position = static_cast<double>(bin) + (target - cumulated) / count;
+                result[channel] = static_cast<float>(histogram.minimum + position * binWidth);
+                break;
+            }
+            cumulated += count;
+        }
+    }
+    return result;
+}
+
+} // namespace stbipp
@@ -0,0 +1,128 @@
+#include "stbipp/ToneMapping.hpp"
+
+#include "FastMath.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+// Number of pixels tone mapped by each task of the multithreaded image tone mapping
+constexpr std::size_t grainSize = 16384;
+
+// Coefficients of the ACES fit (x * (a x + b)) / (x * (c x + d) + e)
+constexpr float acesA = 2.51f;
+constexpr float acesB = 0.03f;
+constexpr float acesC = 2.43f;
+constexpr float acesD = 0.59f;
+constexpr float acesE = 0.14f;
+
+void checkToneMapping(const stbipp::ToneMapping& toneMapping)
+{
+    if(!(toneMapping.gamma > 0.0f) || !(toneMapping.whitePoint >= 0.0f))
+    {
+        throw std::invalid_argument("Tone mapping needs a positive gamma and a non negative white point");
+    }
+}
+
+#if !defined(STBIPP_SIMD_SSE2)
+/**
+ * @brief Tone map a single value, NaN values become 0
+ */
+float toneMapValue(float value, float scale, const stbipp::ToneMapping& toneMapping, float inverseSquaredWhite)
+{
+    float x = value * scale;
+    x = x > 0.0f ? x : 0.0f;
+    switch(toneMapping.toneMapOperator)
+    {
+        case stbipp::ToneMapOperator::REINHARD: x = x * (1.0f + x * inverseSquaredWhite) / (1.0f + x); break;
+        case stbipp::ToneMapOperator::ACES: x = (x * (acesA * x + acesB)) / (x * (acesC * x + acesD) + acesE); break;
+        case stbipp::ToneMapOperator::CLAMP: break;
+    }
+    x = std::min(x, 1.0f);
+    return toneMapping.gamma != 1.0f ? std::pow(x, 1.0f / toneMapping.gamma) : x;
+}
+#endif
+
+} // namespace
+
+namespace stbipp
+{
+void toneMap(const Color4f* source,
+             Color4f* destination,
+             std::size_t count,
+             const ToneMapping& toneMapping,
+             unsigned int colorChannels)
+{
+    checkToneMapping(toneMapping);
+    const float scale = std::exp2(toneMapping.exposure);
+    const float inverseSquaredWhite =
+      toneMapping.whitePoint > 0.0f ? 1.0f / (toneMapping.whitePoint * toneMapping.whitePoint) : 0.0f;
+#if defined(STBIPP_SIMD_SSE2)
+    const __m128 copied = detail::copiedChannelsMask(colorChannels);
+    const __m128 scaleFactor = _mm_set1_ps(scale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 whiteFactor = _mm_set1_ps(inverseSquaredWhite);
+    const float inverseGamma = 1.0f / toneMapping.gamma;
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const __m128 value = _mm_loadu_ps(source[index].data());
+        // _mm_max_ps returns its second operand for NaN values, they become 0
+        __m128 x = _mm_max_ps(_mm_mul_ps(value, scaleFactor), _mm_setzero_ps());
+        switch(toneMapping.toneMapOperator)
+        {
+            case ToneMapOperator::REINHARD:
+                x = _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(one, _mm_mul_ps(x, whiteFactor))), _mm_add_ps(one, x));
+                break;
+            case ToneMapOperator::ACES:
+            {
+                const __m128 numerator =
+                  _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(acesA)), _mm_set1_ps(acesB)));
+                const __m128 denominator = _mm_add_ps(
+                  _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(acesC)), _mm_set1_ps(acesD))), _mm_set1_ps(acesE));
+                x = _mm_div_ps(numerator, denominator);
+                break;
+            }
+            case ToneMapOperator::CLAMP: break;
+        }
+        x = _mm_min_ps(x, one);
+        if(inverseGamma != 1.0f)
+        {
+            // The approximation is only valid for positive values, null values stay null
+            const __m128 positive = _mm_cmpgt_ps(x, _mm_setzero_ps());
+            x = _mm_and_ps(positive, detail::powApprox(x, inverseGamma));
+        }
+        _mm_storeu_ps(destination[index].data(), detail::select(copied, value, x));
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const Color4f value = source[index];
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            destination[index][channel] = channel < colorChannels ?
+                                            toneMapValue(value[channel], scale, toneMapping, inverseSquaredWhite) :
+                                            value[channel];
+        }
+    }
+#endif
+}
+
+void toneMap(Image& image, const ToneMapping& toneMapping, unsigned int threadCount)
+{
+    checkToneMapping(toneMapping);
+    Color4f* pixels = image.data();
+    const auto count = static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height());
+    parallelFor(
+      0,
+      count,
+      grainSize,
+      [pixels, &toneMapping](std::size_t begin, std::size_t end) {
+          toneMap(pixels + begin, pixels + begin, end - begin, toneMapping);
+      },
+      threadCount);
+}
+
+} // namespace stbipp
@@ -0,0 +1,337 @@
+#include "stbipp/Warp.hpp"
+
+#include "Interpolation.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+// Number of pixels computed by each task of the thread pool
+constexpr std::size_t grainSize = 16384;
+
+/**
+ * @brief Source positions along a row of the result for an affine transform, stepped by a constant offset
+ */
+struct AffineSpan
+{
+    double x;
+    double y;
+    double stepX;
+    double stepY;
+
+    bool position(float& positionX, float& positionY) const
+    {
+        positionX = static_cast<float>(x);
+        positionY = static_cast<float>(y);
+        return true;
+    }
+
+    void advance()
+    {
+        x += stepX;
+        y += stepY;
+    }
+};
+
+struct AffineRows
+{
+    stbipp::AffineTransform inverse;
+
+    AffineSpan span(int row) const
+    {
+        const auto& c = inverse.coefficients;
+        return AffineSpan{c[1] * row + c[2], c[4] * row + c[5], c[0], c[3]};
+    }
+};
+
+/**
+ * @brief Homogeneous source positions along a row of the result for a perspective transform
+ */
+struct PerspectiveSpan
+{
+    double x;
+    double y;
+    double w;
+    double stepX;
+    double stepY;
+    double stepW;
+
+    bool position(float& positionX, float& positionY) const
+    {
+        if(w == 0.0)
+        {
+            return false;
+        }
+        positionX = static_cast<float>(x / w);
+        positionY = static_cast<float>(y / w);
+        return true;
+    }
+
+    void advance()
+    {
+        x += stepX;
+        y += stepY;
+        w += stepW;
+    }
+};
+
+struct PerspectiveRows
+{
+    stbipp::PerspectiveTransform inverse;
+
+    PerspectiveSpan span(int row) const
+    {
+        const auto& c = inverse.coefficients;
+        return PerspectiveSpan{c[1] * row + c[2], c[4] * row + c[5], c[7] * row + c[8], c[0], c[3], c[6]};
+    }
+};
+
+/**
+ * @brief Compute the rows of a warped image in bands over several threads
+ * @param[in] image The image sampled, not empty
+ * @param[out] result The warped image
+ * @param[in] rows Gives the source positions of each row of the result
+ * @param[in] options Border mode and thread count
+ */
+template<int tapCount, class Rows>
+void warpRows(const stbipp::Image& image, stbipp::Image& result, const Rows& rows, const stbipp::WarpOptions& options)
+{
+    const int width = result.width();
+    stbipp::Color4f* pixels = result.data();
+    stbipp::parallelFor(
+      0,
+      static_cast<std::size_t>(result.height()),
+      std::max<std::size_t>(1, grainSize / std::max<std::size_t>(static_cast<std::size_t>(width), 1)),
+      [&](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              auto span = rows.span(static_cast<int>(row));
+              stbipp::Color4f* destination = pixels + row * static_cast<std::size_t>(width);
+              for(int column = 0; column < width; ++column, span.advance())
+              {
+                  float x = 0.0f;
+                  float y = 0.0f;
+                  destination[column] =
+                    span.position(x, y) ?
+                      stbipp::detail::samplePoint<tapCount>(image, x, y, options.border, options.borderColor) :
+                      options.borderColor;
+              }
+          }
+      },
+      options.threadCount);
+}
+
+template<class Rows>
+stbipp::Image warp(const stbipp::Image& image, const Rows& rows, const stbipp::WarpOptions& options)
+{
+    if(options.width < 0 || options.height < 0)
+    {
+        throw std::invalid_argument("The dimensions of a warped image can't be negative");
+    }
+    stbipp::Image result(options.width > 0 ? options.width : image.width(),
+                         options.height > 0 ? options.height : image.height());
+    if(image.width() <= 0 || image.height() <= 0)
+    {
+        result.fill(options.borderColor, options.threadCount);
+        return result;
+    }
+    switch(options.filter)
+    {
+        case stbipp::SampleFilter::NEAREST: warpRows<1>(image, result, rows, options); break;
+        case stbipp::SampleFilter::BILINEAR: warpRows<2>(image, result, rows, options); break;
+        case stbipp::SampleFilter::BICUBIC: warpRows<4>(image, result, rows, options); break;
+    }
+    return result;
+}
+
+} // namespace
+
+namespace stbipp
+{
+AffineTransform::AffineTransform(const std::array<double, 6>& coefficients): coefficients(coefficients) {}
+
+AffineTransform AffineTransform::translation(double x, double y)
+{
+    return AffineTransform(std::array<double, 6>{{1.0, 0.0, x, 0.0, 1.0, y}});
+}
+
+AffineTransform AffineTransform::scaling(double x, double y)
+{
+    return AffineTransform(std::array<double, 6>{{x, 0.0, 0.0, 0.0, y, 0.0}});
+}
+
+AffineTransform AffineTransform::rotation(double angle, const Point2f& center)
+{
+    const double cosine = std::cos(angle);
+    const double sine = std::sin(angle);
+    const double x = center.x;
+    const double y = center.y;
+    // Translate the center to the origin, rotate, translate back
+    return AffineTransform(
+      std::array<double, 6>{{cosine, -sine, x - cosine * x + sine * y, sine, cosine, y - sine * x - cosine * y}});
+}
+
+AffineTransform AffineTransform::inverse() const
+{
+    const auto& c = coefficients;
+    const double determinant = c[0] * c[4] - c[1] * c[3];
+    if(determinant == 0.0 || !std::isfinite(determinant))
+    {
+        throw std::invalid_argument("The affine transform is not invertible");
+    }
+    const double a = c[4] / determinant;
+    const double b = -c[1] / determinant;
+    const double d = -c[3] / determinant;
+    const double e = c[0] / determinant;
+    return AffineTransform(std::array<double, 6>{{a, b, -(a * c[2] + b * c[5]), d, e, -(d * c[2] + e * c[5])}});
+}
+
+Point2f AffineTransform::apply(const Point2f& point) const
+{
+    const auto& c = coefficients;
+    return Point2f(static_cast<float>(c[0] * point.x + c[1] * point.y + c[2]),
+                   static_cast<float>(c[3] * point.x + c[4] * point.y + c[5]));
+}
+
+AffineTransform operator*(const AffineTransform& lhs, const AffineTransform& rhs)
+{
+    const auto& l = lhs.coefficients;
+    const auto& r = rhs.coefficients;
+    return AffineTransform(std::array<double, 6>{{l[0] * r[0] + l[1] * r[3],
+                                                  l[0] * r[1] + l[1] * r[4],
+                                                  l[0] * r[2] + l[1] * r[5] + l[2],
+                                                  l[3] * r[0] + l[4] * r[3],
+                                                  l[3] * r[1] + l[4] * r[4],
+                                                  l[3] * r[2] + l[4] * r[5] + l[5]}});
+}
+
+PerspectiveTransform::PerspectiveTransform(const std::array<double, 9>& coefficients): coefficients(coefficients) {}
+
+PerspectiveTransform::PerspectiveTransform(const AffineTransform& transform)
+{
+    std::copy(transform.coefficients.begin(), transform.coefficients.end(), coefficients.begin());
+}
+
+PerspectiveTransform PerspectiveTransform::fromQuadrilaterals(const std::array<Point2f, 4>& source,
+                                                              const std::array<Point2f, 4>& destination)
+{
+    // Each correspondence gives two linear equations on the eight first coefficients, the last one being 1:
+    // c0 x + c1 y + c2 - c6 x x' - c7 y x' = x' and c3 x + c4 y + c5 - c6 x y' - c7 y y' = y'
+    double system[8][9];
+    for(std::size_t index = 0; index < 4; ++index)
+    {
+        const double x = source[index].x;
+        const double y = source[index].y;
+        const double u = destination[index].x;
+        const double v = destination[index].y;
+        const double first[9] = {x, y, 1.0, 0.0, 0.0, 0.0, -x * u, -y * u, u};
+        const double second[9] = {0.0, 0.0, 0.0, x, y, 1.0, -x * v, -y * v, v};
+        std::copy(first, first + 9, system[2 * index]);
+        std::copy(second, second + 9, system[2 * index + 1]);
+    }
+
+    // Gaussian elimination with partial pivoting
+    for(int column = 0; column < 8; ++column)
+    {
+        int pivot = column;
+        for(int row = column + 1; row < 8; ++row)
+        {
+            if(std::fabs(system[row][column]) > std::fabs(system[pivot][column]))
+            {
+                pivot = row;
+            }
+        }
+        if(!(std::fabs(system[pivot][column]) > 1e-12))
+        {
+            throw std::invalid_argument("The quadrilaterals don't define a perspective transform");
+        }
+        std::swap_ranges(system[column], system[column] + 9, system[pivot]);
+        for(int row = 0; row < 8; ++row)
+        {
+            if(row == column)
+            {
+                continue;
+            }
+            const double factor = system[row][column] / system[column][column];
+            for(int index = column; index < 9; ++index)
+            {
+                system[row][index] -= factor * system[column][index];
+            }
+        }
+    }
+
+    PerspectiveTransform transform;
+    for(int index = 0; index < 8; ++index)
+    {
+        transform.coefficients[static_cast<std::size_t>(index)] = system[index][8] / system[index][index];
+    }
+    transform.coefficients[8] = 1.0;
+    return transform;
+}
+
+PerspectiveTransform PerspectiveTransform::inverse() const
+{
+    const auto& c = coefficients;
+    // Transposed matrix of cofactors
+    const std::array<double, 9> adjugate{{c[4] * c[8] - c[5] * c[7],
+                                          c[2] * c[7] - c[1] * c[8],
+                                          c[1] * c[5] - c[2] * c[4],
+                                          c[5] * c[6] - c[3] * c[8],
+                                          c[0] * c[8] - c[2] * c[6],
+                                          c[2] * c[3] - c[0] * c[5],
+                                          c[3] * c[7] - c[4] * c[6],
+                                          c[1] * c[6] - c[0] * c[7],
+                                          c[0] * c[4] - c[1] * c[3]}};
+    const double determinant = c[0] * adjugate[0] + c[1] * adjugate[3] + c[2] * adjugate[6];
+    if(determinant == 0.0 || !std::isfinite(determinant))
+    {
+        throw std::invalid_argument("The perspective transform is not invertible");
+    }
+    PerspectiveTransform result;
+    for(std::size_t index = 0; index < 9; ++index)
+    {
+        result.coefficients[index] = adjugate[index] / determinant;
+    }
+    return result;
+}
+
+Point2f PerspectiveTransform::apply(const Point2f& point) const
+{
+    const auto& c = coefficients;
+    const double w = c[6] * point.x + c[7] * point.y + c[8];
+    return Point2f(static_cast<float>((c[0] * point.x + c[1] * point.y + c[2]) / w),
+                   static_cast<float>((c[3] * point.x + c[4] * point.y + c[5]) / w));
+}
+
+PerspectiveTransform operator*(const PerspectiveTransform& lhs, const PerspectiveTransform& rhs)
+{
+    PerspectiveTransform result;
+    for(std::size_t row = 0; row < 3; ++row)
+    {
+        for(std::size_t column = 0; column < 3; ++column)
+        {
+            double value = 0.0;
+            for(std::size_t index = 0; index < 3; ++index)
+            {
+                value += lhs.coefficients[row * 3 + index] * rhs.coefficients[index * 3 + column];
+            }
+            result.coefficients[row * 3 + column] = value;
+        }
+    }
+    return result;
+}
+
+Image warpAffine(const Image& image, const AffineTransform& transform, const WarpOptions& options)
+{
+    return warp(image, AffineRows{transform.inverse()}, options);
+}
+
+Image warpPerspective(const Image& image, const PerspectiveTransform& transform, const WarpOptions& options)
+{
+    return warp(image, PerspectiveRows{transform.inverse()}, options);
+}
+
+} // namespace stbipp
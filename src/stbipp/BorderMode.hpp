@@ -0,0 +1,49 @@
+#pragma once
+
+namespace stbipp
+{
+/**
+ * @brief How the pixels outside an image are read
+ */
+enum class BorderMode
+{
+    CLAMP,   /// Repeat the border pixels
+    WRAP,    /// Tile the image
+    MIRROR,  /// Mirror the image, the border pixels are repeated once (e.g : 2 1 0 | 0 1 2)
+    CONSTANT /// Use a constant color
+};
+
+/**
+ * @brief Map a coordinate to the coordinate of the pixel read with the given border mode
+ * @param[in] index The coordinate, possibly outside the image
+ * @param[in] size Number of pixels along the axis, greater than 0
+ * @param[in] mode The border mode
+ * @return The coordinate of the pixel to read, -1 if the constant color must be used
+ */
+inline int borderIndex(int index, int size, BorderMode mode)
+{
+    if(index >= 0 && index < size)
+    {
+        return index;
+    }
+    switch(mode)
+    {
+        case BorderMode::CLAMP: return index < 0 ? 0 : size - 1;
+        case BorderMode::WRAP:
+        {
+            const int wrapped = index % size;
+            return wrapped < 0 ? wrapped + size : wrapped;
+        }
+        case BorderMode::MIRROR:
+        {
+            const int period = 2 * size;
+            int mirrored = index % period;
+            mirrored = mirrored < 0 ? mirrored + period : mirrored;
+            return mirrored < size ? mirrored : period - 1 - mirrored;
+        }
+        case BorderMode::CONSTANT: return -1;
+    }
+    return -1;
+}
+
+} // namespace stbipp
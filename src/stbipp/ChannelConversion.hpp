@@ -0,0 +1,171 @@
+#pragma once
+
+#include "stbipp/Half.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace stbipp
+{
+namespace detail
+{
+/**
+ * @brief Table of the float values of the integers [0, size - 1] normalized to [0, 1]
+ */
+template<std::size_t size>
+struct UnormTable
+{
+    UnormTable()
+    {
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            values[index] = static_cast<float>(index) / static_cast<float>(size - 1);
+        }
+    }
+
+    float values[size];
+};
+
+/**
+ * @brief Normalized float values of the 8 bits integers, built on first use
+ * @return Pointer to the 256 values
+ */
+inline const float* unorm8Table()
+{
+    static const UnormTable<256> table;
+    return table.values;
+}
+
+/**
+ * @brief Normalized float values of the 16 bits integers, built on first use
+ * @return Pointer to the 65536 values
+ */
+inline const float* unorm16Table()
+{
+    static const UnormTable<65536> table;
+    return table.values;
+}
+
+/**
+ * @brief Convert a channel value from one data type to another
+ * Integer values are normalized by the maximum value of their type. Floating values are clamped to [0, 1] and
+ * rounded to the nearest integer when converted to an integer type.
+ *
+ * @tparam From Source data type
+ * @tparam To Destination data type
+ */
+template<class From, class To, class Enable = void>
+struct ChannelConverter
+{
+    To operator()(From value) const
+    {
+        return static_cast<To>(value);
+    }
+};
+
+template<class From, class To>
+struct ChannelConverter<
+  From,
+  To,
+  typename std::enable_if<std::is_integral<From>::value && is_floating_data_type<To>::value>::type>
+{
+    To operator()(From value) const
+    {
+        return static_cast<To>(static_cast<double>(value) / static_cast<double>(std::numeric_limits<From>::max()));
+    }
+};
+
+template<class From, class To>
+struct ChannelConverter<
+  From,
+  To,
+  typename std::enable_if<is_floating_data_type<From>::value && std::is_integral<To>::value>::type>
+{
+    To operator()(From value) const
+    {
+        // NaN fails both comparisons and gives 0
+        const double input = static_cast<double>(value);
+        const double clamped = input > 0.0 ? (input < 1.0 ? input : 1.0) : 0.0;
+        return static_cast<To>(clamped * static_cast<double>(std::numeric_limits<To>::max()) + 0.5);
+    }
+};
+
+template<class From, class To>
+struct ChannelConverter<From,
+                        To,
+                        typename std::enable_if<std::is_integral<From>::value && std::is_integral<To>::value &&
+                                                !std::is_same<From, To>::value>::type>
+{
+    To operator()(From value) const
+    {
+        const double normalized = static_cast<double>(value) / static_cast<double>(std::numeric_limits<From>::max());
+        return static_cast<To>(normalized * static_cast<double>(std::numeric_limits<To>::max()) + 0.5);
+    }
+};
+
+template<>
+struct ChannelConverter<unsigned char, float>
+{
+    float operator()(unsigned char value) const
+    {
+        return m_table[value];
+    }
+
+    const float* m_table{unorm8Table()};
+};
+
+template<>
+struct ChannelConverter<unsigned short, float>
+{
+    float operator()(unsigned short value) const
+    {
+        return m_table[value];
+    }
+
+    const float* m_table{unorm16Table()};
+};
+
+template<>
+struct ChannelConverter<float, unsigned char>
+{
+    unsigned char operator()(float value) const
+    {
+        const float clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+        return static_cast<unsigned char>(clamped * 255.0f + 0.5f);
+    }
+};
+
+template<>
+struct ChannelConverter<float, unsigned short>
+{
+    unsigned short operator()(float value) const
+    {
+        const float clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+        return static_cast<unsigned short>(clamped * 65535.0f + 0.5f);
+    }
+};
+
+template<>
+struct ChannelConverter<unsigned char, unsigned short>
+{
+    unsigned short operator()(unsigned char value) const
+    {
+        // value * 257, exact
+        return static_cast<unsigned short>(value << 8 | value);
+    }
+};
+
+template<>
+struct ChannelConverter<unsigned short, unsigned char>
+{
+    unsigned char operator()(unsigned short value) const
+    {
+        // Rounded value / 257
+        const unsigned int biased = static_cast<unsigned int>(value) + 128u;
+        return static_cast<unsigned char>((biased - (biased >> 8)) >> 8);
+    }
+};
+
+} // namespace detail
+} // namespace stbipp
@@ -1,36 +1,20 @@
 #pragma once
 
+#include "stbipp/ChannelConversion.hpp"
+#include "stbipp/ColorArithmetic.hpp"
+#include "stbipp/Half.hpp"
+
 #include <array>
+#include <cstddef>
 #include <limits>
 #include <type_traits>
 
 namespace
 {
-template<class DataType, class ODataType>
-struct is_integer_to_integer_cast
-{
-    static const bool value = (std::is_integral<ODataType>::value && std::is_integral<DataType>::value) &&
-                              !std::is_same<DataType, ODataType>::value;
-};
-
-template<class DataType, class ODataType>
-struct is_float_to_integer_cast
-{
-    static const bool value = (std::is_floating_point<DataType>::value && std::is_integral<ODataType>::value) &&
-                              !std::is_same<DataType, ODataType>::value;
-};
-
-template<class DataType, class ODataType>
-struct is_integer_to_float_cast
-{
-    static const bool value = (std::is_integral<DataType>::value && std::is_floating_point<ODataType>::value) &&
-                              !std::is_same<DataType, ODataType>::value;
-};
-
 template<class DataType>
 struct is_data_type_compatible
 {
-    static const bool value = std::is_integral<DataType>::value || std::is_floating_point<DataType>::value;
+    static const bool value = std::is_integral<DataType>::value || stbipp::is_floating_data_type<DataType>::value;
 };
 } // namespace
 
@@ -38,6 +22,7 @@ namespace stbipp
 {
 /**
  * @brief Color class works like a classic mathematical vector with basic arithmetic operations
+ * Colors are trivially copyable and only hold their channels, so arrays of colors can be copied with memcpy.
  *
  * @tparam DataType Type used to store individual elements
  * @tparam channels Number of channels for the color
@@ -45,7 +30,8 @@ namespace stbipp
 template<class DataType, unsigned int channels>
 class Color
 {
-    static_assert(is_data_type_compatible<DataType>::value, "Data type must be an integer or floating point type");
+    static_assert(is_data_type_compatible<DataType>::value,
+                  "Data type must be an integer, floating point or half type");
     static_assert(channels, "Color must have at least one channel");
 
   private:
@@ -107,14 +93,14 @@ class Color
      *
      * @param[in] other Color to copy
      */
-    Color(const Color& other);
+    Color(const Color& other) = default;
 
     /**
      * @brief Color move constructor
      *
      * @param other Color to move
      */
-    Color(Color&& other);
+    Color(Color&& other) = default;
 
     /**
      * @brief Color copy operator
@@ -123,7 +109,7 @@ class Color
      *
      * @return Reference to the color
      */
-    Color& operator=(const Color& other);
+    Color& operator=(const Color& other) = default;
 
     /**
      * @brief Color move operator
@@ -132,7 +118,7 @@ class Color
      *
      * @return Reference to the color
      */
-    Color& operator=(Color&& other);
+    Color& operator=(Color&& other) = default;
 
     /**
      * @brief Returns an iterator pointing to the first color channel
@@ -298,37 +284,12 @@ class Color
 
   private:
     /**
-     * @brief Copy data of another color into this, with other uses the same data type as this but with possibly a
-     * different length
+     * @brief Copy data of another color into this, converting the channels to the data type of this (see
+     * convertPixels) and setting the channels missing in other to 0
      * @param[in] other Color to copy
      */
     template<typename ODataType, unsigned int oDataSize>
-    void copy(const Color<ODataType, oDataSize>& other,
-              typename std::enable_if<std::is_same<DataType, ODataType>::value>::type* = nullptr);
-
-    /**
-     * @brief Copy data of another color into this, with other using an integer type and this a floating type
-     * @param[in] other Color to copy
-     */
-    template<class ODataType, unsigned int oDataSize>
-    void copy(const Color<ODataType, oDataSize>& other,
-              typename std::enable_if<is_float_to_integer_cast<DataType, ODataType>::value>::type* = nullptr);
-
-    /**
-     * @brief Copy data of another color into this, with other using a floating type and this an integer type
-     * @param[in] other Color to copy
-     */
-    template<class ODataType, unsigned int oDataSize>
-    void copy(const Color<ODataType, oDataSize>& other,
-              typename std::enable_if<is_integer_to_float_cast<DataType, ODataType>::value>::type* = nullptr);
-
-    /**
-     * @brief Copy data of another color into this, with this and other using different integer types
-     * @param[in] other Color to copy
-     */
-    template<class ODataType, unsigned int oDataSize>
-    void copy(const Color<ODataType, oDataSize>& other,
-              typename std::enable_if<is_integer_to_integer_cast<DataType, ODataType>::value>::type* = nullptr);
+    void copy(const Color<ODataType, oDataSize>& other);
 
   public:
     /**
@@ -511,6 +472,124 @@ class Color
     template<class Real>
     typename std::enable_if<is_data_type_compatible<Real>::value, Color>::type operator/(Real val) const;
 };
+
+/**
+ * @brief Channel wise minimum of two colors
+ * @param[in] lhs First color
+ * @param[in] rhs Second color
+ * @return A color holding the smallest value of each channel
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> minimum(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs);
+
+/**
+ * @brief Channel wise maximum of two colors
+ * @param[in] lhs First color
+ * @param[in] rhs Second color
+ * @return A color holding the greatest value of each channel
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> maximum(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs);
+
+/**
+ * @brief Clamp each channel of a color between the channels of two other colors
+ * @param[in] color The color to clamp
+ * @param[in] lower Lower bound of each channel
+ * @param[in] upper Upper bound of each channel
+ * @return The clamped color
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> clamp(const Color<DataType, channels>& color,
+                                const Color<DataType, channels>& lower,
+                                const Color<DataType, channels>& upper);
+
+/**
+ * @brief Clamp all the channels of a color between two values
+ * @param[in] color The color to clamp
+ * @param[in] lower Lower bound of the channels
+ * @param[in] upper Upper bound of the channels
+ * @return The clamped color
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> clamp(const Color<DataType, channels>& color, DataType lower, DataType upper);
+
+/**
+ * @brief Dot product of two colors
+ * @param[in] lhs First color
+ * @param[in] rhs Second color
+ * @return The sum of the products of each channel
+ */
+template<class DataType, unsigned int channels>
+DataType dot(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs);
+
+/**
+ * @brief Add two colors, channels overflowing are set to the maximum value of the data type
+ * @param[in] lhs First color
+ * @param[in] rhs Second color
+ * @return The saturated addition of lhs and rhs
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> addSaturated(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs);
+
+/**
+ * @brief Substract two colors, channels underflowing are set to 0
+ * @param[in] lhs First color
+ * @param[in] rhs Second color
+ * @return The saturated substraction of lhs by rhs
+ */
+template<class DataType, unsigned int channels>
+Color<DataType, channels> subtractSaturated(const Color<DataType, channels>& lhs,
+                                            const Color<DataType, channels>& rhs);
+
+/**
+ * @brief Copy an array of colors, the arrays may overlap
+ * @param[in] source First color to copy
+ * @param[out] destination First color written
+ * @param[in] count Number of colors to copy
+ */
+template<class DataType, unsigned int channels>
+void copyPixels(const Color<DataType, channels>* source, Color<DataType, channels>* destination, std::size_t count);
+
+/**
+ * @brief Convert an array of colors to another color type
+ * Integer channels are normalized by the maximum value of their type, 8 and 16 bits channels are converted to float
+ * with lookup tables and between each other with shifts. Float channels are clamped to [0, 1] and rounded to the
+ * nearest integer. Channels missing in the source are set to 0.
+ * @param[in] source First color to convert
+ * @param[out] destination First color written, the arrays must not overlap
+ * @param[in] count Number of colors to convert
+ */
+template<class DataType, unsigned int channels, class ODataType, unsigned int oChannels>
+void convertPixels(const Color<DataType, channels>* source,
+                   Color<ODataType, oChannels>* destination,
+                   std::size_t count);
+
+/**
+ * @brief Copy an array of colors of the same type, see copyPixels
+ */
+template<class DataType, unsigned int channels>
+void convertPixels(const Color<DataType, channels>* source, Color<DataType, channels>* destination, std::size_t count);
+
+/**
+ * @brief Convert an array of float colors to half colors, see floatToHalf
+ */
+template<unsigned int channels>
+void convertPixels(const Color<float, channels>* source, Color<half, channels>* destination, std::size_t count);
+
+/**
+ * @brief Convert an array of half colors to float colors, see halfToFloat
+ */
+template<unsigned int channels>
+void convertPixels(const Color<half, channels>* source, Color<float, channels>* destination, std::size_t count);
+
+/**
+ * @brief Set all the colors of an array to the same value
+ * @param[out] destination First color written
+ * @param[in] count Number of colors to write
+ * @param[in] value Color written
+ */
+template<class DataType, unsigned int channels>
+void fillPixels(Color<DataType, channels>* destination, std::size_t count, const Color<DataType, channels>& value);
 } // namespace stbipp
 
 template<class DataType, unsigned int channels, class Real>
@@ -534,6 +613,11 @@ using Color2f = Color<float, 2>;
 using Color3f = Color<float, 3>;
 using Color4f = Color<float, 4>;
 
+using Colord = Color<double, 1>;
+using Color2d = Color<double, 2>;
+using Color3d = Color<double, 3>;
+using Color4d = Color<double, 4>;
+
 using Coloruc = Color<unsigned char, 1>;
 using Color2uc = Color<unsigned char, 2>;
 using Color3uc = Color<unsigned char, 3>;
@@ -543,4 +627,20 @@ using Colorus = Color<unsigned short, 1>;
 using Color2us = Color<unsigned short, 2>;
 using Color3us = Color<unsigned short, 3>;
 using Color4us = Color<unsigned short, 4>;
+
+using Colorh = Color<half, 1>;
+using Color2h = Color<half, 2>;
+using Color3h = Color<half, 3>;
+using Color4h = Color<half, 4>;
+
+static_assert(std::is_trivially_copyable<Color4f>::value && std::is_trivially_copyable<Color4uc>::value &&
+                std::is_trivially_copyable<Color4us>::value && std::is_trivially_copyable<Color3f>::value &&
+                std::is_trivially_copyable<Color4h>::value,
+              "Colors must be trivially copyable to be copied with memcpy");
+static_assert(std::is_standard_layout<Color4f>::value && std::is_standard_layout<Color4uc>::value &&
+                std::is_standard_layout<Color4us>::value && std::is_standard_layout<Color3f>::value,
+              "Colors must have a standard layout to be reinterpreted as arrays of channels");
+static_assert(sizeof(Color4f) == 4 * sizeof(float) && sizeof(Color3uc) == 3 && sizeof(Color3us) == 6 &&
+                sizeof(Color3h) == 6,
+              "Colors must not be padded");
 } // namespace stbipp
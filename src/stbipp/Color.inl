@@ -38,30 +38,6 @@ Color<DataType, channels>::Color(const DataType* data)
     memcpy(m_data.data(), data, channels * sizeof(DataType));
 }
 
-template<class DataType, unsigned int channels>
-Color<DataType, channels>::Color(const Color<DataType, channels>& other): m_data(other.m_data)
-{
-}
-
-template<class DataType, unsigned int channels>
-Color<DataType, channels>::Color(Color<DataType, channels>&& other): m_data(std::move(other.m_data))
-{
-}
-
-template<class DataType, unsigned int channels>
-Color<DataType, channels>& Color<DataType, channels>::operator=(const Color<DataType, channels>& other)
-{
-    std::copy(other.m_data.cbegin(), other.m_data.cend(), m_data.begin());
-    return *this;
-}
-
-template<class DataType, unsigned int channels>
-Color<DataType, channels>& Color<DataType, channels>::operator=(Color<DataType, channels>&& other)
-{
-    std::swap(other.m_data, m_data);
-    return *this;
-}
-
 template<class DataType, unsigned int channels>
 typename Color<DataType, channels>::iterator Color<DataType, channels>::begin() noexcept
 {
@@ -234,56 +210,15 @@ bool Color<DataType, channels>::operator!=(const Color<DataType, channels>& othe
 
 template<class DataType, unsigned int channels>
 template<class ODataType, unsigned int oDataSize>
-void Color<DataType, channels>::copy(const Color<ODataType, oDataSize>& other,
-                                     typename std::enable_if<std::is_same<DataType, ODataType>::value>::type*)
-{
-    std::size_t minSize = std::min(oDataSize, channels);
-    std::copy_n(other.cbegin(), minSize, begin());
-    std::fill(begin() + minSize, end(), 0.0);
-}
-
-template<class DataType, unsigned int channels>
-template<class ODataType, unsigned int oDataSize>
-void Color<DataType, channels>::copy(
-  const Color<ODataType, oDataSize>& other,
-  typename std::enable_if<is_float_to_integer_cast<DataType, ODataType>::value>::type*)
-{
-    std::size_t minSize = std::min(oDataSize, channels);
-    for(std::size_t index = 0; index < minSize; ++index)
-    {
-        m_data[index] = static_cast<DataType>(other[static_cast<int>(index)]) / std::numeric_limits<ODataType>::max();
-    }
-    std::fill(begin() + minSize, end(), 0.0);
-}
-
-template<class DataType, unsigned int channels>
-template<class ODataType, unsigned int oDataSize>
-void Color<DataType, channels>::copy(
-  const Color<ODataType, oDataSize>& other,
-  typename std::enable_if<is_integer_to_float_cast<DataType, ODataType>::value>::type*)
+void Color<DataType, channels>::copy(const Color<ODataType, oDataSize>& other)
 {
-    std::size_t minSize = std::min(oDataSize, channels);
-    for(std::size_t index = 0; index < minSize; ++index)
+    const detail::ChannelConverter<ODataType, DataType> convert{};
+    const unsigned int minSize = std::min(oDataSize, channels);
+    for(unsigned int index = 0; index < minSize; ++index)
     {
-        m_data[index] = static_cast<DataType>(std::numeric_limits<DataType>::max() * other[static_cast<int>(index)]);
+        m_data[index] = convert(other.data()[index]);
     }
-    std::fill(begin() + minSize, end(), 0.0);
-}
-
-template<class DataType, unsigned int channels>
-template<class ODataType, unsigned int oDataSize>
-void Color<DataType, channels>::copy(
-  const Color<ODataType, oDataSize>& other,
-  typename std::enable_if<is_integer_to_integer_cast<DataType, ODataType>::value>::type*)
-{
-    std::size_t minSize = std::min(oDataSize, channels);
-    for(std::size_t index = 0; index < minSize; ++index)
-    {
-        m_data[index] =
-          static_cast<DataType>((static_cast<double>(other[index]) * std::numeric_limits<DataType>::max()) /
-                                std::numeric_limits<ODataType>::max());
-    }
-    std::fill(begin() + minSize, end(), 0.0);
+    std::fill(begin() + minSize, end(), DataType{0});
 }
 
 template<class DataType, unsigned int channels>
@@ -311,7 +246,7 @@ Color<DataType, channels>& Color<DataType, channels>::operator+=(const Color<ODa
 {
     static_assert(oDataSize == channels && std::is_same<DataType, ODataType>::value,
                   "Both colors must be of the same size and type");
-    std::transform(begin(), end(), other.begin(), begin(), [](DataType lhs, ODataType rhs) { return lhs + rhs; });
+    detail::ColorArithmetic<DataType, channels>::add(data(), other.data());
     return *this;
 }
 
@@ -320,7 +255,7 @@ template<class Real>
 typename std::enable_if<is_data_type_compatible<Real>::value, Color<DataType, channels>>::type&
 Color<DataType, channels>::operator+=(Real val)
 {
-    std::transform(begin(), end(), begin(), [val](DataType lhs) { return lhs + val; });
+    detail::ColorArithmetic<DataType, channels>::addScalar(data(), val);
     return *this;
 }
 
@@ -349,7 +284,7 @@ Color<DataType, channels>& Color<DataType, channels>::operator-=(const Color<ODa
 {
     static_assert(oDataSize == channels && std::is_same<DataType, ODataType>::value,
                   "Both colors must be of the same size and type");
-    std::transform(begin(), end(), other.begin(), begin(), [](DataType lhs, ODataType rhs) { return lhs - rhs; });
+    detail::ColorArithmetic<DataType, channels>::subtract(data(), other.data());
     return *this;
 }
 
@@ -358,7 +293,7 @@ template<class Real>
 typename std::enable_if<is_data_type_compatible<Real>::value, Color<DataType, channels>>::type&
 Color<DataType, channels>::operator-=(Real val)
 {
-    std::transform(begin(), end(), begin(), [val](DataType lhs) { return lhs - val; });
+    detail::ColorArithmetic<DataType, channels>::subtractScalar(data(), val);
     return *this;
 }
 
@@ -394,15 +329,16 @@ Color<DataType, channels>& Color<DataType, channels>::operator*=(const Color<ODa
 {
     static_assert(oDataSize == channels && std::is_same<DataType, ODataType>::value,
                   "Both colors must be of the same size and type");
-    std::transform(begin(), end(), other.begin(), begin(), [](DataType lhs, ODataType rhs) { return lhs * rhs; });
+    detail::ColorArithmetic<DataType, channels>::multiply(data(), other.data());
     return *this;
-} // namespace stbipp
+}
+
 template<class DataType, unsigned int channels>
 template<class Real>
 typename std::enable_if<is_data_type_compatible<Real>::value, Color<DataType, channels>>::type&
 Color<DataType, channels>::operator*=(Real val)
 {
-    std::transform(begin(), end(), begin(), [val](DataType lhs) { return lhs * val; });
+    detail::ColorArithmetic<DataType, channels>::multiplyScalar(data(), val);
     return *this;
 }
 
@@ -431,7 +367,7 @@ Color<DataType, channels>& Color<DataType, channels>::operator/=(const Color<ODa
 {
     static_assert(oDataSize == channels && std::is_same<DataType, ODataType>::value,
                   "Both colors must be of the same size and type");
-    std::transform(begin(), end(), other.begin(), begin(), [](DataType lhs, ODataType rhs) { return lhs / rhs; });
+    detail::ColorArithmetic<DataType, channels>::divide(data(), other.data());
     return *this;
 }
 
@@ -440,7 +376,7 @@ template<class Real>
 typename std::enable_if<is_data_type_compatible<Real>::value, Color<DataType, channels>>::type&
 Color<DataType, channels>::operator/=(Real val)
 {
-    std::transform(begin(), end(), begin(), [val](DataType lhs) { return lhs / val; });
+    detail::ColorArithmetic<DataType, channels>::divideScalar(data(), val);
     return *this;
 }
 
@@ -462,6 +398,136 @@ Color<DataType, channels>::operator/(Real val) const
     Color temp{*this};
     return temp /= val;
 }
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> minimum(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs)
+{
+    Color<DataType, channels> result{lhs};
+    detail::ColorArithmetic<DataType, channels>::minimum(result.data(), rhs.data());
+    return result;
+}
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> maximum(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs)
+{
+    Color<DataType, channels> result{lhs};
+    detail::ColorArithmetic<DataType, channels>::maximum(result.data(), rhs.data());
+    return result;
+}
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> clamp(const Color<DataType, channels>& color,
+                                const Color<DataType, channels>& lower,
+                                const Color<DataType, channels>& upper)
+{
+    Color<DataType, channels> result{color};
+    detail::ColorArithmetic<DataType, channels>::maximum(result.data(), lower.data());
+    detail::ColorArithmetic<DataType, channels>::minimum(result.data(), upper.data());
+    return result;
+}
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> clamp(const Color<DataType, channels>& color, DataType lower, DataType upper)
+{
+    return clamp(color, Color<DataType, channels>{lower}, Color<DataType, channels>{upper});
+}
+
+template<class DataType, unsigned int channels>
+DataType dot(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs)
+{
+    return detail::ColorArithmetic<DataType, channels>::dot(lhs.data(), rhs.data());
+}
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> addSaturated(const Color<DataType, channels>& lhs, const Color<DataType, channels>& rhs)
+{
+    Color<DataType, channels> result{lhs};
+    detail::SaturatedArithmetic<DataType, channels>::add(result.data(), rhs.data());
+    return result;
+}
+
+template<class DataType, unsigned int channels>
+Color<DataType, channels> subtractSaturated(const Color<DataType, channels>& lhs,
+                                            const Color<DataType, channels>& rhs)
+{
+    Color<DataType, channels> result{lhs};
+    detail::SaturatedArithmetic<DataType, channels>::subtract(result.data(), rhs.data());
+    return result;
+}
+
+template<class DataType, unsigned int channels>
+void copyPixels(const Color<DataType, channels>* source, Color<DataType, channels>* destination, std::size_t count)
+{
+    if(count > 0)
+    {
+        std::memmove(destination, source, count * sizeof(Color<DataType, channels>));
+    }
+}
+
+template<class DataType, unsigned int channels, class ODataType, unsigned int oChannels>
+void convertPixels(const Color<DataType, channels>* source,
+                   Color<ODataType, oChannels>* destination,
+                   std::size_t count)
+{
+    const detail::ChannelConverter<DataType, ODataType> convert{};
+    const unsigned int minChannels = std::min(channels, oChannels);
+    for(std::size_t index = 0; index < count; ++index)
+    {
+        const DataType* input = source[index].data();
+        ODataType* output = destination[index].data();
+        for(unsigned int channel = 0; channel < minChannels; ++channel)
+        {
+            output[channel] = convert(input[channel]);
+        }
+        for(unsigned int channel = minChannels; channel < oChannels; ++channel)
+        {
+            output[channel] = ODataType{0};
+        }
+    }
+}
+
+template<class DataType, unsigned int channels>
+void convertPixels(const Color<DataType, channels>* source, Color<DataType, channels>* destination, std::size_t count)
+{
+    copyPixels(source, destination, count);
+}
+
+template<unsigned int channels>
+void convertPixels(const Color<float, channels>* source, Color<half, channels>* destination, std::size_t count)
+{
+    floatToHalf(reinterpret_cast<const float*>(source), reinterpret_cast<half*>(destination), count * channels);
+}
+
+template<unsigned int channels>
+void convertPixels(const Color<half, channels>* source, Color<float, channels>* destination, std::size_t count)
+{
+    halfToFloat(reinterpret_cast<const half*>(source), reinterpret_cast<float*>(destination), count * channels);
+}
+
+template<class DataType, unsigned int channels>
+void fillPixels(Color<DataType, channels>* destination, std::size_t count, const Color<DataType, channels>& value)
+{
+    if(count == 0)
+    {
+        return;
+    }
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+    if(std::all_of(bytes, bytes + sizeof(value), [bytes](unsigned char byte) { return byte == bytes[0]; }))
+    {
+        std::memset(static_cast<void*>(destination), bytes[0], count * sizeof(value));
+        return;
+    }
+    // Copy the already filled colors ahead, the chunks stay small enough for their source to remain in the cache
+    const std::size_t maxChunk = std::max<std::size_t>(1, 16384 / sizeof(value));
+    destination[0] = value;
+    std::size_t filled = 1;
+    while(filled < count)
+    {
+        const std::size_t chunk = std::min(std::min(filled, maxChunk), count - filled);
+        std::memcpy(destination + filled, destination, chunk * sizeof(value));
+        filled += chunk;
+    }
+}
 } // namespace stbipp
 
 template<class DataType, unsigned int channels, class Real>
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// The SIMD code paths are selected at compile time, define STBIPP_NO_SIMD to only use the portable ones
+#if !defined(STBIPP_NO_SIMD) && \
+  (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STBIPP_SIMD_SSE2
+#include <emmintrin.h>
+#elif !defined(STBIPP_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+#define STBIPP_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace stbipp
+{
+namespace detail
+{
+/**
+ * @brief Channel wise arithmetic used by Color, specialized with SIMD instructions for the most common color types
+ *
+ * @tparam DataType Type used to store individual elements
+ * @tparam channels Number of channels for the color
+ */
+template<class DataType, unsigned int channels>
+struct ColorArithmetic
+{
+    static void add(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] + rhs[index];
+        }
+    }
+
+    static void subtract(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] - rhs[index];
+        }
+    }
+
+    static void multiply(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] * rhs[index];
+        }
+    }
+
+    static void divide(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] / rhs[index];
+        }
+    }
+
+    template<class Real>
+    static void addScalar(DataType* lhs, Real val)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] + val;
+        }
+    }
+
+    template<class Real>
+    static void subtractScalar(DataType* lhs, Real val)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] - val;
+        }
+    }
+
+    template<class Real>
+    static void multiplyScalar(DataType* lhs, Real val)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] * val;
+        }
+    }
+
+    template<class Real>
+    static void divideScalar(DataType* lhs, Real val)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] / val;
+        }
+    }
+
+    static void minimum(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = std::min(lhs[index], rhs[index]);
+        }
+    }
+
+    static void maximum(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = std::max(lhs[index], rhs[index]);
+        }
+    }
+
+    static DataType dot(const DataType* lhs, const DataType* rhs)
+    {
+        DataType sum{0};
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            sum += lhs[index] * rhs[index];
+        }
+        return sum;
+    }
+};
+
+/**
+ * @brief Channel wise saturated arithmetic used by the color free functions, specialized with SIMD instructions for
+ * Color<unsigned char, 4>
+ *
+ * @tparam DataType Type used to store individual elements
+ * @tparam channels Number of channels for the color
+ */
+template<class DataType, unsigned int channels>
+struct SaturatedArithmetic
+{
+    static_assert(std::is_unsigned<DataType>::value, "Saturated arithmetic requires an unsigned integer data type");
+
+    static void add(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] > std::numeric_limits<DataType>::max() - rhs[index] ?
+                           std::numeric_limits<DataType>::max() :
+                           static_cast<DataType>(lhs[index] + rhs[index]);
+        }
+    }
+
+    static void subtract(DataType* lhs, const DataType* rhs)
+    {
+        for(unsigned int index = 0; index < channels; ++index)
+        {
+            lhs[index] = lhs[index] < rhs[index] ? DataType{0} : static_cast<DataType>(lhs[index] - rhs[index]);
+        }
+    }
+};
+
+#if defined(STBIPP_SIMD_SSE2) || defined(STBIPP_SIMD_NEON)
+
+#if defined(STBIPP_SIMD_SSE2)
+using float4 = __m128;
+
+inline float4 load(const float* data)
+{
+    return _mm_loadu_ps(data);
+}
+
+inline void store(float* data, float4 value)
+{
+    _mm_storeu_ps(data, value);
+}
+
+inline float4 broadcast(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+inline float4 add(float4 lhs, float4 rhs)
+{
+    return _mm_add_ps(lhs, rhs);
+}
+
+inline float4 subtract(float4 lhs, float4 rhs)
+{
+    return _mm_sub_ps(lhs, rhs);
+}
+
+inline float4 multiply(float4 lhs, float4 rhs)
+{
+    return _mm_mul_ps(lhs, rhs);
+}
+
+inline float4 divide(float4 lhs, float4 rhs)
+{
+    return _mm_div_ps(lhs, rhs);
+}
+
+// Operands are swapped so NaN channels behave like std::min and std::max
+inline float4 minimum(float4 lhs, float4 rhs)
+{
+    return _mm_min_ps(rhs, lhs);
+}
+
+inline float4 maximum(float4 lhs, float4 rhs)
+{
+    return _mm_max_ps(rhs, lhs);
+}
+
+inline float horizontalSum(float4 value)
+{
+    const __m128 pairs = _mm_add_ps(value, _mm_movehl_ps(value, value));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+inline std::uint32_t addSaturated(std::uint32_t lhs, std::uint32_t rhs)
+{
+    const __m128i sum =
+      _mm_adds_epu8(_mm_cvtsi32_si128(static_cast<int>(lhs)), _mm_cvtsi32_si128(static_cast<int>(rhs)));
+    return static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum));
+}
+
+inline std::uint32_t subtractSaturated(std::uint32_t lhs, std::uint32_t rhs)
+{
+    const __m128i difference =
+      _mm_subs_epu8(_mm_cvtsi32_si128(static_cast<int>(lhs)), _mm_cvtsi32_si128(static_cast<int>(rhs)));
+    return static_cast<std::uint32_t>(_mm_cvtsi128_si32(difference));
+}
+#else
+using float4 = float32x4_t;
+
+inline float4 load(const float* data)
+{
+    return vld1q_f32(data);
+}
+
+inline void store(float* data, float4 value)
+{
+    vst1q_f32(data, value);
+}
+
+inline float4 broadcast(float value)
+{
+    return vdupq_n_f32(value);
+}
+
+inline float4 add(float4 lhs, float4 rhs)
+{
+    return vaddq_f32(lhs, rhs);
+}
+
+inline float4 subtract(float4 lhs, float4 rhs)
+{
+    return vsubq_f32(lhs, rhs);
+}
+
+inline float4 multiply(float4 lhs, float4 rhs)
+{
+    return vmulq_f32(lhs, rhs);
+}
+
+inline float4 divide(float4 lhs, float4 rhs)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vdivq_f32(lhs, rhs);
+#else
+    // 32 bits NEON has no division
+    float lhsData[4];
+    float rhsData[4];
+    vst1q_f32(lhsData, lhs);
+    vst1q_f32(rhsData, rhs);
+    for(int index = 0; index < 4; ++index)
+    {
+        lhsData[index] /= rhsData[index];
+    }
+    return vld1q_f32(lhsData);
+#endif
+}
+
+// Selects are used instead of vminq_f32 and vmaxq_f32 so NaN channels behave like std::min and std::max
+inline float4 minimum(float4 lhs, float4 rhs)
+{
+    return vbslq_f32(vcltq_f32(rhs, lhs), rhs, lhs);
+}
+
+inline float4 maximum(float4 lhs, float4 rhs)
+{
+    return vbslq_f32(vcltq_f32(lhs, rhs), rhs, lhs);
+}
+
+inline float horizontalSum(float4 value)
+{
+    const float32x2_t pairs = vadd_f32(vget_low_f32(value), vget_high_f32(value));
+    return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+}
+
+inline std::uint32_t addSaturated(std::uint32_t lhs, std::uint32_t rhs)
+{
+    const uint8x8_t sum = vqadd_u8(vreinterpret_u8_u32(vdup_n_u32(lhs)), vreinterpret_u8_u32(vdup_n_u32(rhs)));
+    return vget_lane_u32(vreinterpret_u32_u8(sum), 0);
+}
+
+inline std::uint32_t subtractSaturated(std::uint32_t lhs, std::uint32_t rhs)
+{
+    const uint8x8_t difference =
+      vqsub_u8(vreinterpret_u8_u32(vdup_n_u32(lhs)), vreinterpret_u8_u32(vdup_n_u32(rhs)));
+    return vget_lane_u32(vreinterpret_u32_u8(difference), 0);
+}
+#endif
+
+/**
+ * @brief Color<float, 4> arithmetic working on the four channels at once, scalar values are converted to float first
+ */
+template<>
+struct ColorArithmetic<float, 4>
+{
+    static void add(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::add(load(lhs), load(rhs)));
+    }
+
+    static void subtract(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::subtract(load(lhs), load(rhs)));
+    }
+
+    static void multiply(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::multiply(load(lhs), load(rhs)));
+    }
+
+    static void divide(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::divide(load(lhs), load(rhs)));
+    }
+
+    template<class Real>
+    static void addScalar(float* lhs, Real val)
+    {
+        store(lhs, detail::add(load(lhs), broadcast(static_cast<float>(val))));
+    }
+
+    template<class Real>
+    static void subtractScalar(float* lhs, Real val)
+    {
+        store(lhs, detail::subtract(load(lhs), broadcast(static_cast<float>(val))));
+    }
+
+    template<class Real>
+    static void multiplyScalar(float* lhs, Real val)
+    {
+        store(lhs, detail::multiply(load(lhs), broadcast(static_cast<float>(val))));
+    }
+
+    template<class Real>
+    static void divideScalar(float* lhs, Real val)
+    {
+        store(lhs, detail::divide(load(lhs), broadcast(static_cast<float>(val))));
+    }
+
+    static void minimum(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::minimum(load(lhs), load(rhs)));
+    }
+
+    static void maximum(float* lhs, const float* rhs)
+    {
+        store(lhs, detail::maximum(load(lhs), load(rhs)));
+    }
+
+    static float dot(const float* lhs, const float* rhs)
+    {
+        return horizontalSum(detail::multiply(load(lhs), load(rhs)));
+    }
+};
+
+/**
+ * @brief Color<unsigned char, 4> saturated arithmetic working on the four channels at once
+ */
+template<>
+struct SaturatedArithmetic<unsigned char, 4>
+{
+    static void add(unsigned char* lhs, const unsigned char* rhs)
+    {
+        std::uint32_t lhsData;
+        std::uint32_t rhsData;
+        std::memcpy(&lhsData, lhs, sizeof(lhsData));
+        std::memcpy(&rhsData, rhs, sizeof(rhsData));
+        lhsData = addSaturated(lhsData, rhsData);
+        std::memcpy(lhs, &lhsData, sizeof(lhsData));
+    }
+
+    static void subtract(unsigned char* lhs, const unsigned char* rhs)
+    {
+        std::uint32_t lhsData;
+        std::uint32_t rhsData;
+        std::memcpy(&lhsData, lhs, sizeof(lhsData));
+        std::memcpy(&rhsData, rhs, sizeof(rhsData));
+        lhsData = subtractSaturated(lhsData, rhsData);
+        std::memcpy(lhs, &lhsData, sizeof(lhsData));
+    }
+};
+
+#endif
+
+} // namespace detail
+} // namespace stbipp
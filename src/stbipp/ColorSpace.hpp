@@ -0,0 +1,117 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+#include "stbipp/TypedImage.hpp"
+
+#include <cstddef>
+
+namespace stbipp
+{
+/**
+ * @brief The color spaces an RGB color can be converted to, the channels of each space are stored in r, g and b
+ * All the channels are in [0, 1] for RGB colors in [0, 1], so they can be stored in 8 bits images. The alpha channel is
+ * never modified.
+ */
+enum class ColorSpace
+{
+    RGB,         /// Red, green, blue
+    YCBCR_BT601, /// Full range luma and chroma with the BT.601 coefficients, the chroma are centered on 0.5 (JPEG)
+    YCBCR_BT709, /// Full range luma and chroma with the BT.709 coefficients, the chroma are centered on 0.5
+    HSV,         /// Hue in turns [0, 1), saturation, value
+    HSL          /// Hue in turns [0, 1), saturation, lightness
+};
+
+/**
+ * @brief The weights of the red, green and blue channels in the luminance
+ */
+enum class LumaCoefficients
+{
+    BT601, /// 0.299, 0.587, 0.114
+    BT709  /// 0.2126, 0.7152, 0.0722 (sRGB primaries)
+};
+
+/**
+ * @brief Convert colors from one color space to another
+ * With SSE2 instructions four colors are converted at once. source and destination may be equal.
+ * @param[in] source First color to convert
+ * @param[out] destination First color written
+ * @param[in] count Number of colors
+ * @param[in] from Color space of the source colors
+ * @param[in] to Color space of the destination colors, conversions between two non RGB spaces go through RGB
+ */
+STBIPP_API void convertColorSpace(const Color4f* source,
+                                  Color4f* destination,
+                                  std::size_t count,
+                                  ColorSpace from,
+                                  ColorSpace to);
+
+/**
+ * @brief Convert the colors of an image from one color space to another in place
+ * @param[in,out] image The image to convert
+ * @param[in] from Color space of the image
+ * @param[in] to Color space of the result
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void convertColorSpace(Image& image, ColorSpace from, ColorSpace to, unsigned int threadCount = 1);
+
+/**
+ * @brief Convert the colors of an 8 bits image from one color space to another in place
+ * The rows are converted through a float buffer, the results are rounded to the nearest integer.
+ * @param[in,out] image The image to convert
+ * @param[in] from Color space of the image
+ * @param[in] to Color space of the result
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void convertColorSpace(TypedImage<Color3uc>& image,
+                                  ColorSpace from,
+                                  ColorSpace to,
+                                  unsigned int threadCount = 1);
+
+/**
+ * @brief Convert the colors of an 8 bits image with alpha from one color space to another in place
+ * The rows are converted through a float buffer, the results are rounded to the nearest integer.
+ * @param[in,out] image The image to convert
+ * @param[in] from Color space of the image
+ * @param[in] to Color space of the result
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void convertColorSpace(TypedImage<Color4uc>& image,
+                                  ColorSpace from,
+                                  ColorSpace to,
+                                  unsigned int threadCount = 1);
+
+/**
+ * @brief Compute the weighted luminance of RGB colors
+ * @param[in] source First color
+ * @param[out] destination First luminance written
+ * @param[in] count Number of colors
+ * @param[in] coefficients Weights of the red, green and blue channels
+ */
+STBIPP_API void computeLuminance(const Color4f* source,
+                                 float* destination,
+                                 std::size_t count,
+                                 LumaCoefficients coefficients = LumaCoefficients::BT709);
+
+/**
+ * @brief Replace the red, green and blue channels of an image by their weighted luminance, the alpha channel is kept
+ * @param[in,out] image The RGB image
+ * @param[in] coefficients Weights of the red, green and blue channels
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void convertToLuminance(Image& image,
+                                   LumaCoefficients coefficients = LumaCoefficients::BT709,
+                                   unsigned int threadCount = 1);
+
+/**
+ * @brief Replace the red, green and blue channels of an 8 bits image by their weighted luminance
+ * @param[in,out] image The RGB image
+ * @param[in] coefficients Weights of the red, green and blue channels
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void convertToLuminance(TypedImage<Color4uc>& image,
+                                   LumaCoefficients coefficients = LumaCoefficients::BT709,
+                                   unsigned int threadCount = 1);
+
+} // namespace stbipp
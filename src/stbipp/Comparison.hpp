@@ -0,0 +1,59 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+
+namespace stbipp
+{
+/**
+ * @brief Settings of the image comparison
+ */
+struct ComparisonOptions
+{
+    bool structuralSimilarity{true}; /// Compute the SSIM, the most expensive metric
+    bool heatmap{false};             /// Build an image showing where the images differ
+    float heatmapMaximum{1.0f};      /// Absolute error drawn in white in the heatmap, smaller errors go through red
+    unsigned int threadCount{1};     /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Per channel differences between two images
+ */
+struct ImageComparison
+{
+    Color4f meanSquaredError{};       /// Mean of the squared differences
+    Color4f peakSignalToNoiseRatio{}; /// PSNR in decibels for a peak value of 1, infinite for identical channels
+    Color4f maximumAbsoluteError{};   /// Largest absolute difference
+    Color4f structuralSimilarity{};   /// Mean SSIM over 11x11 gaussian windows (sigma 1.5), 1 for identical channels
+    Image heatmap{};                  /// Black where the images are equal, then red, yellow and white for larger errors
+};
+
+/**
+ * @brief Compare two images of the same dimensions
+ * The errors are reduced over chunks of pixels by several threads, with partial sums merged in a fixed order so the
+ * result does not depend on the thread count. The SSIM uses the local means, variances and covariance computed by
+ * separable gaussian convolutions with mirrored borders, and the constants (0.01)^2 and (0.03)^2 of a peak value of 1.
+ * @param[in] lhs The first image
+ * @param[in] rhs The second image
+ * @param[in] options Metrics computed and thread count
+ * @throw std::invalid_argument if the images dimensions differ
+ * @return The differences, the structural similarity is 0 if not computed and the heatmap empty if not built
+ */
+STBIPP_API ImageComparison compareImages(const Image& lhs,
+                                         const Image& rhs,
+                                         const ComparisonOptions& options = ComparisonOptions{});
+
+/**
+ * @brief Check if two images have the same dimensions and differ by at most a tolerance on every channel
+ * The threads stop as soon as one of them finds a difference above the tolerance, so different images are rejected
+ * quickly.
+ * @param[in] lhs The first image
+ * @param[in] rhs The second image
+ * @param[in] tolerance Largest absolute difference accepted
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @return true if all the absolute differences are lower or equal to the tolerance, NaN differences are rejected
+ */
+STBIPP_API bool isWithinTolerance(const Image& lhs, const Image& rhs, float tolerance, unsigned int threadCount = 1);
+
+} // namespace stbipp
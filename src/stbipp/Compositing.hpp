@@ -0,0 +1,122 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Rect.hpp"
+#include "stbipp/StbippSymbols.h"
+#include "stbipp/TypedImage.hpp"
+
+#include <cstddef>
+
+namespace stbipp
+{
+/**
+ * @brief How a source pixel is combined with the destination pixel below it
+ * The colors are premultiplied by their alpha, each operator applies the same formula to the color and alpha channels.
+ */
+enum class CompositeOperator
+{
+    OVER,     /// Source over destination : s + d * (1 - as)
+    IN,       /// Source where the destination is opaque : s * ad
+    OUT,      /// Source where the destination is transparent : s * (1 - ad)
+    ATOP,     /// Source over destination, only where the destination is opaque : s * ad + d * (1 - as)
+    XOR,      /// Source and destination where the other is transparent : s * (1 - ad) + d * (1 - as)
+    PLUS,     /// Sum of source and destination : s + d (saturated for 8 bits colors)
+    MULTIPLY, /// Multiply blend mode composited over the destination : s * d + s * (1 - ad) + d * (1 - as)
+    SCREEN    /// Screen blend mode composited over the destination : s + d - s * d
+};
+
+/**
+ * @brief Settings of the compositing operations
+ */
+struct CompositeOptions
+{
+    Rect sourceRegion{};         /// Region of the source composited, an empty region uses the whole source
+    int x{0};                    /// Column of the destination receiving the top left pixel of the source region
+    int y{0};                    /// Row of the destination receiving the top left pixel of the source region
+    unsigned int threadCount{1}; /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Multiply the color channels by the alpha channel
+ * @param[in,out] colors The colors to premultiply
+ * @param[in] count Number of colors
+ */
+STBIPP_API void premultiplyAlpha(Color4f* colors, std::size_t count);
+
+/**
+ * @brief Multiply the color channels by the alpha channel, rounding to the nearest value
+ * @param[in,out] colors The colors to premultiply
+ * @param[in] count Number of colors
+ */
+STBIPP_API void premultiplyAlpha(Color4uc* colors, std::size_t count);
+
+/**
+ * @brief Divide the color channels by the alpha channel, colors with a null alpha become transparent black
+ * @param[in,out] colors The premultiplied colors
+ * @param[in] count Number of colors
+ */
+STBIPP_API void unpremultiplyAlpha(Color4f* colors, std::size_t count);
+
+/**
+ * @brief Divide the color channels by the alpha channel, colors with a null alpha become transparent black
+ * @param[in,out] colors The premultiplied colors
+ * @param[in] count Number of colors
+ */
+STBIPP_API void unpremultiplyAlpha(Color4uc* colors, std::size_t count);
+
+/**
+ * @brief Multiply the color channels of an image by its alpha channel
+ * @param[in,out] image The image to premultiply
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void premultiplyAlpha(Image& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Multiply the color channels of an 8 bits image by its alpha channel
+ * @param[in,out] image The image to premultiply
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void premultiplyAlpha(TypedImage<Color4uc>& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Divide the color channels of an image by its alpha channel
+ * @param[in,out] image The premultiplied image
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void unpremultiplyAlpha(Image& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Divide the color channels of an 8 bits image by its alpha channel
+ * @param[in,out] image The premultiplied image
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void unpremultiplyAlpha(TypedImage<Color4uc>& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Composite a premultiplied image onto another one
+ * The source region is clipped to the source and destination bounds, the destination pixels outside of it are left
+ * unchanged. The rows are composited in bands over several threads.
+ * @param[in] source The premultiplied image drawn
+ * @param[in,out] destination The premultiplied image receiving the result
+ * @param[in] compositeOperator How the source and destination pixels are combined
+ * @param[in] options Source region, destination position and thread count
+ */
+STBIPP_API void composite(const Image& source,
+                          Image& destination,
+                          CompositeOperator compositeOperator,
+                          const CompositeOptions& options = CompositeOptions{});
+
+/**
+ * @brief Composite a premultiplied 8 bits image onto another one, with integer arithmetic rounded to nearest
+ * @param[in] source The premultiplied image drawn
+ * @param[in,out] destination The premultiplied image receiving the result
+ * @param[in] compositeOperator How the source and destination pixels are combined
+ * @param[in] options Source region, destination position and thread count
+ */
+STBIPP_API void composite(const TypedImage<Color4uc>& source,
+                          TypedImage<Color4uc>& destination,
+                          CompositeOperator compositeOperator,
+                          const CompositeOptions& options = CompositeOptions{});
+
+} // namespace stbipp
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "stbipp/BorderMode.hpp"
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief The Kernel1D class holds the weights of a one dimensional convolution kernel centered on its middle weight
+ */
+class STBIPP_API Kernel1D
+{
+  public:
+    /**
+     * @brief Kernel constructor
+     * @param[in] weights The weights, from the leftmost (or topmost) pixel to the rightmost one
+     * @throw std::invalid_argument if the number of weights is not odd
+     */
+    explicit Kernel1D(std::vector<float> weights);
+
+    /**
+     * @brief Create a normalized gaussian kernel
+     * @param[in] sigma Standard deviation in pixels, greater than 0
+     * @param[in] radius Number of weights on each side of the center, 0 uses ceil(3 * sigma)
+     * @throw std::invalid_argument if sigma is not positive or radius is negative
+     * @return The kernel
+     */
+    static Kernel1D gaussian(float sigma, int radius = 0);
+
+    /**
+     * @brief Create a normalized box kernel, averaging 2 * radius + 1 pixels
+     * @param[in] radius Number of weights on each side of the center
+     * @throw std::invalid_argument if radius is negative
+     * @return The kernel
+     */
+    static Kernel1D box(int radius);
+
+    /**
+     * @brief Number of weights on each side of the center
+     * @return The radius
+     */
+    int radius() const;
+
+    /**
+     * @brief Access the weights
+     * @return The 2 * radius + 1 weights
+     */
+    const std::vector<float>& weights() const;
+
+  private:
+    std::vector<float> m_weights;
+};
+
+/**
+ * @brief Settings of the convolutions
+ */
+struct ConvolutionOptions
+{
+    BorderMode border{BorderMode::CLAMP}; /// How the pixels outside the image are read
+    Color4f borderColor{};                /// Color of the pixels outside the image with BorderMode::CONSTANT
+    unsigned int threadCount{1};          /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Convolve an image with a separable kernel
+ * The rows are convolved with the horizontal kernel then the columns with the vertical one. Both passes are split in
+ * row bands over several threads, the vertical pass processes the columns in blocks that fit in the cache.
+ * @param[in] image The image to convolve
+ * @param[in] horizontal Kernel applied along the rows
+ * @param[in] vertical Kernel applied along the columns
+ * @param[in] options The convolution settings
+ * @return The convolved image
+ */
+STBIPP_API Image convolveSeparable(const Image& image,
+                                   const Kernel1D& horizontal,
+                                   const Kernel1D& vertical,
+                                   const ConvolutionOptions& options = ConvolutionOptions{});
+
+/**
+ * @brief Blur an image with a gaussian kernel
+ * @param[in] image The image to blur
+ * @param[in] sigma Standard deviation in pixels, greater than 0
+ * @param[in] options The convolution settings
+ * @throw std::invalid_argument if sigma is not positive
+ * @return The blurred image
+ */
+STBIPP_API Image gaussianBlur(const Image& image,
+                              float sigma,
+                              const ConvolutionOptions& options = ConvolutionOptions{});
+
+/**
+ * @brief Blur an image with a box filter averaging (2 * radius + 1)^2 pixels
+ * Running sums are used, so the cost per pixel does not depend on the radius.
+ * @param[in] image The image to blur
+ * @param[in] radius Number of pixels on each side of the center
+ * @param[in] options The convolution settings
+ * @throw std::invalid_argument if radius is negative
+ * @return The blurred image
+ */
+STBIPP_API Image boxBlur(const Image& image, int radius, const ConvolutionOptions& options = ConvolutionOptions{});
+
+} // namespace stbipp
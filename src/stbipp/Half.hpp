@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// F16C converts 8 values per instruction, it is only used when the compiler targets it (e.g : -mf16c, -march=native)
+#if !defined(STBIPP_NO_SIMD) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define STBIPP_SIMD_F16C
+#include <immintrin.h>
+#elif !defined(STBIPP_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+#define STBIPP_SIMD_NEON_FP16
+#include <arm_neon.h>
+#endif
+
+namespace stbipp
+{
+namespace detail
+{
+/**
+ * @brief Convert a float to the bits of the nearest half float (ties to even)
+ * Values too large become infinities and NaNs stay NaNs.
+ */
+inline std::uint16_t floatToHalfBits(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    std::uint32_t result;
+    if(bits >= 0x47800000u)
+    {
+        // Too large for a half, infinity or NaN
+        result = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    }
+    else if(bits < 0x38800000u)
+    {
+        // Denormal half or zero, the float addition does the rounding
+        const std::uint32_t magicBits = 0x3F000000u;
+        float magic;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+        float shifted;
+        std::memcpy(&shifted, &bits, sizeof(shifted));
+        shifted += magic;
+        std::memcpy(&bits, &shifted, sizeof(bits));
+        result = bits - magicBits;
+    }
+    else
+    {
+        const std::uint32_t mantissaOdd = (bits >> 13) & 1u;
+        // Rebias the exponent from 127 to 15 and round the mantissa
+        bits += 0xC8000FFFu + mantissaOdd;
+        result = bits >> 13;
+    }
+    return static_cast<std::uint16_t>(result | (sign >> 16));
+}
+
+/**
+ * @brief Convert the bits of a half float to a float, exact
+ */
+inline float halfBitsToFloat(std::uint16_t value)
+{
+    const std::uint32_t magicBits = (254u - 15u) << 23;
+    const std::uint32_t infinityOrNaNBits = (127u + 16u) << 23;
+    float magic;
+    std::memcpy(&magic, &magicBits, sizeof(magic));
+
+    std::uint32_t bits = static_cast<std::uint32_t>(value & 0x7FFFu) << 13;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    // Rebias the exponent, denormal halves become normal floats
+    result *= magic;
+    std::memcpy(&bits, &result, sizeof(bits));
+    if(bits >= infinityOrNaNBits)
+    {
+        bits |= 255u << 23;
+    }
+    bits |= static_cast<std::uint32_t>(value & 0x8000u) << 16;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+} // namespace detail
+
+/**
+ * @brief 16 bits IEEE 754 floating point number (1 sign bit, 5 exponent bits, 10 mantissa bits)
+ * Halves are only meant to store values, arithmetic is done on floats through the implicit conversions.
+ */
+class half
+{
+  public:
+    /**
+     * @brief Half default constructor, the value is 0
+     */
+    half() = default;
+
+    /**
+     * @brief Half constructor, rounds the value to the nearest half
+     * @param[in] value The value to store
+     */
+    half(float value): m_bits(detail::floatToHalfBits(value)) {}
+
+    /**
+     * @brief Create a half from its binary representation
+     * @param[in] bits The bits of the half
+     * @return The half
+     */
+    static half fromBits(std::uint16_t bits)
+    {
+        half value;
+        value.m_bits = bits;
+        return value;
+    }
+
+    /**
+     * @brief Access the binary representation
+     * @return The bits of the half
+     */
+    std::uint16_t bits() const
+    {
+        return m_bits;
+    }
+
+    /**
+     * @brief Convert the half to a float, exact
+     */
+    operator float() const
+    {
+        return detail::halfBitsToFloat(m_bits);
+    }
+
+    half& operator+=(float value)
+    {
+        return *this = static_cast<float>(*this) + value;
+    }
+
+    half& operator-=(float value)
+    {
+        return *this = static_cast<float>(*this) - value;
+    }
+
+    half& operator*=(float value)
+    {
+        return *this = static_cast<float>(*this) * value;
+    }
+
+    half& operator/=(float value)
+    {
+        return *this = static_cast<float>(*this) / value;
+    }
+
+  private:
+    std::uint16_t m_bits{0};
+};
+
+static_assert(sizeof(half) == 2 && std::is_trivially_copyable<half>::value, "half must be stored on 16 bits");
+
+/**
+ * @brief Check if a channel data type stores floating point values (float, double or half)
+ */
+template<class DataType>
+struct is_floating_data_type
+{
+    static const bool value = std::is_floating_point<DataType>::value || std::is_same<DataType, half>::value;
+};
+
+/**
+ * @brief Convert an array of floats to halves, with F16C or NEON instructions when available
+ * @param[in] source First value to convert
+ * @param[out] destination First half written
+ * @param[in] count Number of values to convert
+ */
+inline void floatToHalf(const float* source, half* destination, std::size_t count)
+{
+    std::size_t index = 0;
+#if defined(STBIPP_SIMD_F16C)
+    for(; index + 8 <= count; index += 8)
+    {
+        const __m128i converted = _mm256_cvtps_ph(_mm256_loadu_ps(source + index), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index), converted);
+    }
+#elif defined(STBIPP_SIMD_NEON_FP16)
+    for(; index + 4 <= count; index += 4)
+    {
+        const float16x4_t converted = vcvt_f16_f32(vld1q_f32(source + index));
+        vst1_u16(reinterpret_cast<std::uint16_t*>(destination + index), vreinterpret_u16_f16(converted));
+    }
+#endif
+    for(; index < count; ++index)
+    {
+        destination[index] = half(source[index]);
+    }
+}
+
+/**
+ * @brief Convert an array of halves to floats, with F16C or NEON instructions when available
+ * @param[in] source First half to convert
+ * @param[out] destination First value written
+ * @param[in] count Number of values to convert
+ */
+inline void halfToFloat(const half* source, float* destination, std::size_t count)
+{
+    std::size_t index = 0;
+#if defined(STBIPP_SIMD_F16C)
+    for(; index + 8 <= count; index += 8)
+    {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        _mm256_storeu_ps(destination + index, _mm256_cvtph_ps(packed));
+    }
+#elif defined(STBIPP_SIMD_NEON_FP16)
+    for(; index + 4 <= count; index += 4)
+    {
+        const uint16x4_t packed = vld1_u16(reinterpret_cast<const std::uint16_t*>(source + index));
+        vst1q_f32(destination + index, vcvt_f32_f16(vreinterpret_f16_u16(packed)));
+    }
+#endif
+    for(; index < count; ++index)
+    {
+        destination[index] = static_cast<float>(source[index]);
+    }
+}
+
+} // namespace stbipp
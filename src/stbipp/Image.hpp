@@ -2,6 +2,7 @@
 
 #include "stbipp/Color.hpp"
 #include "stbipp/ImageFormat.hpp"
+#include "stbipp/Parallel.hpp"
 #include "stbipp/StbippSymbols.h"
 
 #include <memory>
@@ -9,6 +10,9 @@
 
 namespace stbipp
 {
+template<class Expression>
+class ImageExpression;
+
 /**
  * @brief The Image class is a 2D pixel matrix
  * A pixel with 4 float channels
@@ -47,8 +51,9 @@ class STBIPP_API Image
      * (must be set depending on the data argument
      * e.g : RGBA8 this means that data is pointing to an unsigned char array of dimension :
      * width * height * formatChannelCount(pixelFormat))
+     * @param[in] threadCount Maximum number of threads converting the data, 0 uses all the hardware threads
      */
-    Image(const void* data, int width, int height, ImageFormat pixelFormat);
+    Image(const void* data, int width, int height, ImageFormat pixelFormat, unsigned int threadCount = 1);
 
     /**
      * @brief Image copy constructor
@@ -62,6 +67,13 @@ class STBIPP_API Image
      */
     Image(Image&& other);
 
+    /**
+     * @brief Image constructor, evaluate an image expression in a single pass (see ImageExpression.hpp)
+     * @param[in] expression The expression evaluated for each pixel
+     */
+    template<class Expression>
+    Image(const ImageExpression<Expression>& expression);
+
     /**
      * @brief Image destructor
      */
@@ -82,8 +94,9 @@ class STBIPP_API Image
     /**
      * @brief Fill the image with the given color
      * @param[in] color The image will be filled with this color
+     * @param[in] threadCount Maximum number of threads filling the pixels, 0 uses all the hardware threads
      */
-    void fill(const Color& color);
+    void fill(const Color& color, unsigned int threadCount = 1);
 
     /**
      * @brief Resize the image with the given dimensions
@@ -95,17 +108,23 @@ class STBIPP_API Image
     /**
      * @brief Cast data to another color type
      * @tparam ColorType The new color type (e.g : Color3uc, Colorus,...)
+     * @param[in] threadCount Maximum number of threads converting the pixels, 0 uses all the hardware threads
      * @return The pixel matrix casted
      */
     template<class ColorType>
-    std::vector<ColorType> castData() const
+    std::vector<ColorType> castData(unsigned int threadCount = 1) const
     {
-        std::size_t size = m_width * m_height;
-        std::vector<ColorType> castedValue(size);
-        for(std::size_t index = 0; index < size; ++index)
-        {
-            castedValue[index] = m_data[index];
-        }
+        std::vector<ColorType> castedValue(m_data.size());
+        const Color* source = m_data.data();
+        ColorType* destination = castedValue.data();
+        parallelFor(
+          0,
+          m_data.size(),
+          16384,
+          [source, destination](std::size_t begin, std::size_t end) {
+              convertPixels(source + begin, destination + begin, end - begin);
+          },
+          threadCount);
         return castedValue;
     }
 
@@ -151,6 +170,14 @@ class STBIPP_API Image
      */
     Image& operator=(Image&& other) = default;
 
+    /**
+     * @brief Evaluate an image expression in a single pass, the image may appear in the expression
+     * @param[in] expression The expression evaluated for each pixel
+     * @return A reference to the image
+     */
+    template<class Expression>
+    Image& operator=(const ImageExpression<Expression>& expression);
+
   private:
     /**
      * @brief Copy the data of the other image into this
@@ -164,8 +191,9 @@ class STBIPP_API Image
      * @param[in] width Image width
      * @param[in] height Image height
      * @param[in] pixelFormat The pixel format describing the data format
+     * @param[in] threadCount Maximum number of threads converting the data
      */
-    void copyData(const unsigned char* data, int width, int height, ImageFormat pixelFormat);
+    void copyData(const unsigned char* data, int width, int height, ImageFormat pixelFormat, unsigned int threadCount);
 
     /**
      * @brief Copy the data at the given location
@@ -173,8 +201,9 @@ class STBIPP_API Image
      * @param[in] width Image width
      * @param[in] height Image height
      * @param[in] pixelFormat The pixel format describing the data format
+     * @param[in] threadCount Maximum number of threads converting the data
      */
-    void copyData(const unsigned short* data, int width, int height, ImageFormat pixelFormat);
+    void copyData(const unsigned short* data, int width, int height, ImageFormat pixelFormat, unsigned int threadCount);
 
     /**
      * @brief Copy the data at the given location
@@ -182,8 +211,9 @@ class STBIPP_API Image
      * @param[in] width Image width
      * @param[in] height Image height
      * @param[in] pixelFormat The pixel format describing the data format
+     * @param[in] threadCount Maximum number of threads converting the data
      */
-    void copyData(const float* data, int width, int height, ImageFormat pixelFormat);
+    void copyData(const float* data, int width, int height, ImageFormat pixelFormat, unsigned int threadCount);
 
     /**
      * @brief Resize the pixel matrix
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "stbipp/Image.hpp"
+#include "stbipp/ImageExporter.hpp"
+#include "stbipp/ImageFormat.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief The image file formats known by stbipp
+ */
+enum class ImageFileFormat
+{
+    JPEG, /// JPEG baseline & progressive
+    PNG,  /// Portable Network Graphics
+    BMP,  /// Windows bitmap
+    TGA,  /// Truevision TGA
+    PSD,  /// Photoshop document (composited view only)
+    GIF,  /// Graphics Interchange Format (first frame only)
+    HDR,  /// Radiance rgbE
+    PIC,  /// Softimage PIC
+    PNM,  /// Portable pixmap and graymap (binary only)
+    QOI,  /// Quite OK Image, fast lossless format
+    RAW,  /// stbipp raw snapshot, see saveRaw and loadRaw
+
+    CUSTOM = -1 /// Format provided by a codec registered by the user
+};
+
+/**
+ * @brief What a codec is able to read or write
+ */
+struct CodecCapabilities
+{
+    std::vector<int> bitDepths;     /// Bits per channel handled (e.g : {8, 16})
+    std::vector<int> channelCounts; /// Channel counts handled (e.g : {1, 3})
+    bool streaming{false};          /// Rows can be read or written one at a time
+};
+
+/**
+ * @brief Read the file at the given path into an image
+ * The arguments and the return value are the same as loadImage ones.
+ */
+using ImageDecodeFunction = std::function<bool(const std::string&, Image&, const ImageFormat)>;
+
+/**
+ * @brief Write an image at the given path
+ * The arguments and the return value are the same as saveImage ones.
+ */
+using ImageEncodeFunction =
+  std::function<bool(const std::string&, const Image&, const ImageSaveFormat, const SaveOptions&)>;
+
+/**
+ * @brief An image file format handler
+ */
+struct ImageCodec
+{
+    std::string name;                                /// Unique name of the codec (e.g : "PNG")
+    ImageFileFormat format{ImageFileFormat::CUSTOM}; /// The file format handled
+    std::vector<std::string> extensions;             /// Lower case file extensions, without the dot
+    std::vector<std::string> signatures;             /// Magic bytes found at the beginning of the files
+    CodecCapabilities decoding;                      /// What the decoder reads
+    CodecCapabilities encoding;                      /// What the encoder writes
+    ImageDecodeFunction decode;                      /// Empty if the codec can't read files
+    ImageEncodeFunction encode;                      /// Empty if the codec can't write files
+};
+
+/**
+ * @brief The CodecRegistry class maps file extensions, magic bytes and file formats to the codec handling them
+ * The stbipp codecs are registered when the registry is first accessed. loadImage and saveImage pick their codec
+ * through the registry, so registering a codec makes it available to them. All the functions are thread safe.
+ */
+class STBIPP_API CodecRegistry
+{
+  public:
+    using CodecPtr = std::shared_ptr<const ImageCodec>;
+
+    /**
+     * @brief Access the registry shared by the library
+     * @return The registry
+     */
+    static CodecRegistry& instance();
+
+    CodecRegistry(const CodecRegistry&) = delete;
+    CodecRegistry& operator=(const CodecRegistry&) = delete;
+
+    /**
+     * @brief Register a codec
+     * A codec with the same name as an already registered one replaces it. When several codecs share an extension
+     * or a signature, the last registered one is used.
+     * @param[in] codec The codec to register
+     */
+    void registerCodec(const ImageCodec& codec);
+
+    /**
+     * @brief Retrieve all the registered codecs
+     * @return The codecs in registration order
+     */
+    std::vector<CodecPtr> codecs() const;
+
+    /**
+     * @brief Find the codec of a file format
+     * @param[in] format The file format (CUSTOM formats can only be found by name)
+     * @return The codec, or nullptr if none is registered
+     */
+    CodecPtr find(ImageFileFormat format) const;
+
+    /**
+     * @brief Find a codec by its name
+     * @param[in] name The codec name
+     * @return The codec, or nullptr if none is registered
+     */
+    CodecPtr findByName(const std::string& name) const;
+
+    /**
+     * @brief Find the codec handling a file extension
+     * @param[in] extension The extension, without the dot, case insensitive
+     * @return The codec, or nullptr if none is registered
+     */
+    CodecPtr findByExtension(const std::string& extension) const;
+
+    /**
+     * @brief Find the codec whose signature starts the given data
+     * @param[in] data The first bytes of a file
+     * @param[in] size Number of bytes available in data
+     * @return The codec, or nullptr if no signature matches
+     */
+    CodecPtr findBySignature(const unsigned char* data, std::size_t size) const;
+
+    /**
+     * @brief Find the codec of a file, from its first bytes if they match a signature, else from its extension
+     * @param[in] path Path to the file
+     * @return The codec, or nullptr if none matches
+     */
+    CodecPtr findForFile(const std::string& path) const;
+
+  private:
+    CodecRegistry();
+
+    /**
+     * @brief Rebuild the extension and signature lookup tables, m_mutex must be locked
+     */
+    void rebuildIndex();
+
+    mutable std::mutex m_mutex;
+    std::vector<CodecPtr> m_codecs;
+    std::unordered_map<std::string, CodecPtr> m_extensions;
+    std::vector<std::pair<std::string, CodecPtr>> m_signatures;
+    std::size_t m_maxSignatureSize{0};
+};
+
+} // namespace stbipp
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "stbipp/Image.hpp"
+#include "stbipp/ToneMapping.hpp"
+#include "stbipp/TypedImage.hpp"
 
 #include <string>
 
@@ -17,21 +19,95 @@ enum class ImageSaveFormat
     RGBA  /// Save the image as an RGB with alpha image
 };
 
+/**
+ * @brief The filter applied by the PNG encoder on each row before compression
+ */
+enum class PngFilter
+{
+    ADAPTIVE, /// Pick the filter giving the best compression estimate for each row
+    NONE,     /// Store the raw values
+    SUB,      /// Difference with the pixel on the left
+    UP,       /// Difference with the pixel above
+    AVERAGE,  /// Difference with the average of the pixels on the left and above
+    PAETH     /// Difference with the Paeth predictor
+};
+
+/**
+ * @brief Settings of the stbipp PNG encoder
+ */
+struct PngEncoderSettings
+{
+    int compressionLevel{6};               /// From 0 (no compression, fastest) to 9 (smallest files, slowest)
+    PngFilter filter{PngFilter::ADAPTIVE}; /// Row filter, ADAPTIVE stores raw values with compression level 0
+    unsigned int threadCount{1};           /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Encoder options used during save operation
+ * The options only apply to the call they are given to, so concurrent saves may use different options.
+ */
+struct SaveOptions
+{
+    int jpegQuality{100};        /// JPEG quality from 1 (smallest files) to 100 (best quality)
+    PngEncoderSettings png{};    /// PNG compression settings
+    bool tgaRle{true};           /// Compress TGA files with run length encoding
+    bool flipVertically{false};  /// Write the image rows from bottom to top
+    bool linearToSrgb{false};    /// Encode the color channels of 8 bits formats from linear to sRGB values
+    ToneMapping toneMapping{};   /// Tone mapping of 8 bits formats, applied before the sRGB encoding
+    unsigned int threadCount{1}; /// Maximum number of threads converting the pixels, 0 uses all the hardware threads
+};
+
 /**
  * @brief Save the given image at the given path with the specified format
  *  * Stbipp uses the same save function you'll find in stb_image_write meaning that you are able to load the same file
  * format :
  * - JPEG
- * - PNG
+ * - PNG (written with the stbipp PNG encoder)
  * - BMP
  * - TGA
  * - HDR
+ * The codec is picked from the path extension through the CodecRegistry, so codecs registered by the user are also
+ * available.
+ * @param[in] path Path to the image to save
+ * @param[in] image The image containing the data to save
+ * @param[in] pixelFormat The pixel format to use
+ * @param[in] options Encoder options, the ones not related to the saved file format are ignored
+ * @return true if the save operation was successful
+ */
+STBIPP_API bool saveImage(const std::string& path,
+                          const Image& image,
+                          const ImageSaveFormat pixelFormat,
+                          const SaveOptions& options = SaveOptions{});
+
+/**
+ * @brief Save a half float image
+ * HDR files are written from the halves converted back to 32 bits floats row by row, other file formats are saved
+ * from an Image converted first.
+ * @param[in] path Path to the image to save
+ * @param[in] image The image containing the data to save
+ * @param[in] pixelFormat The pixel format to use
+ * @param[in] options Encoder options, the ones not related to the saved file format are ignored
+ * @return true if the save operation was successful
+ */
+STBIPP_API bool saveImage(const std::string& path,
+                          const HalfImage& image,
+                          const ImageSaveFormat pixelFormat,
+                          const SaveOptions& options = SaveOptions{});
+
+/**
+ * @brief Save the given image as a PNG file using the stbipp multithreaded encoder
+ * The image is split in row bands that are filtered and compressed in parallel. Each band restarts the compression
+ * window, so files written with several threads are slightly larger than the ones written with a single one.
  * @param[in] path Path to the image to save
  * @param[in] image The image containing the data to save
  * @param[in] pixelFormat The pixel format to use
+ * @param[in] settings Compression level and number of threads to use
  * @return true if the save operation was successful
  */
-STBIPP_API bool saveImage(const std::string& path, const Image& image, const ImageSaveFormat pixelFormat);
+STBIPP_API bool savePng(const std::string& path,
+                        const Image& image,
+                        const ImageSaveFormat pixelFormat,
+                        const PngEncoderSettings& settings);
 
 /**
  * @brief Return the numbers of channel the given format have
@@ -0,0 +1,539 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Parallel.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace stbipp
+{
+/**
+ * @brief Base class of the image expressions
+ * Arithmetic on images builds a tree of expressions instead of computing intermediate images. The tree is evaluated
+ * once per pixel when it is assigned to an image, so a whole expression is computed in a single pass.
+ * Expressions keep references to the images they use, they must be evaluated before these images are destroyed.
+ *
+ * @tparam Expression The derived expression, providing width(), height() and operator[](std::size_t index)
+ */
+template<class Expression>
+class ImageExpression
+{
+  public:
+    /**
+     * @brief Access the derived expression
+     * @return A reference to the derived expression
+     */
+    const Expression& derived() const
+    {
+        return static_cast<const Expression&>(*this);
+    }
+
+    /**
+     * @brief Width of the images used in the expression
+     * @return The width, -1 if the expression only uses constants
+     */
+    int width() const
+    {
+        return derived().width();
+    }
+
+    /**
+     * @brief Height of the images used in the expression
+     * @return The height, -1 if the expression only uses constants
+     */
+    int height() const
+    {
+        return derived().height();
+    }
+};
+
+/**
+ * @brief Expression reading the pixels of an image
+ */
+class ImageTerminal: public ImageExpression<ImageTerminal>
+{
+  public:
+    explicit ImageTerminal(const Image& image): m_data(image.data()), m_width(image.width()), m_height(image.height())
+    {
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    Color4f operator[](std::size_t index) const
+    {
+        return m_data[index];
+    }
+
+  private:
+    const Color4f* m_data;
+    int m_width;
+    int m_height;
+};
+
+/**
+ * @brief Expression giving the same color for every pixel, it has no size and can be combined with any image
+ */
+class ScalarTerminal: public ImageExpression<ScalarTerminal>
+{
+  public:
+    explicit ScalarTerminal(const Color4f& value): m_value(value) {}
+
+    int width() const
+    {
+        return -1;
+    }
+
+    int height() const
+    {
+        return -1;
+    }
+
+    Color4f operator[](std::size_t) const
+    {
+        return m_value;
+    }
+
+  private:
+    Color4f m_value;
+};
+
+namespace detail
+{
+/**
+ * @brief Retrieve the size shared by several operands, operands without size (-1) match any size
+ * @return The shared size
+ */
+inline int combineSize(int lhs, int rhs)
+{
+    if(lhs >= 0 && rhs >= 0 && lhs != rhs)
+    {
+        throw std::invalid_argument("The images of an expression must have the same dimensions");
+    }
+    return lhs >= 0 ? lhs : rhs;
+}
+
+/**
+ * @brief Convert the operands of the image operators (images, expressions, colors and numbers) to expressions
+ */
+template<class Operand, class Enable = void>
+struct ExpressionOperand
+{
+};
+
+template<>
+struct ExpressionOperand<Image>
+{
+    using type = ImageTerminal;
+
+    static type make(const Image& image)
+    {
+        return type(image);
+    }
+};
+
+template<class Operand>
+struct ExpressionOperand<Operand,
+                         typename std::enable_if<std::is_base_of<ImageExpression<Operand>, Operand>::value>::type>
+{
+    using type = Operand;
+
+    static const type& make(const Operand& expression)
+    {
+        return expression;
+    }
+};
+
+template<class Operand>
+struct ExpressionOperand<Operand, typename std::enable_if<std::is_arithmetic<Operand>::value>::type>
+{
+    using type = ScalarTerminal;
+
+    static type make(Operand value)
+    {
+        return type(Color4f(static_cast<float>(value)));
+    }
+};
+
+template<>
+struct ExpressionOperand<Color4f>
+{
+    using type = ScalarTerminal;
+
+    static type make(const Color4f& value)
+    {
+        return type(value);
+    }
+};
+
+template<class Operand>
+struct is_image_operand
+{
+    static const bool value =
+      std::is_same<Operand, Image>::value || std::is_base_of<ImageExpression<Operand>, Operand>::value;
+};
+
+template<class Operand>
+using expression_type = typename ExpressionOperand<Operand>::type;
+
+template<class Operand>
+expression_type<Operand> makeExpression(const Operand& operand)
+{
+    return ExpressionOperand<Operand>::make(operand);
+}
+
+struct AddOperation
+{
+    Color4f operator()(const Color4f& lhs, const Color4f& rhs) const
+    {
+        return lhs + rhs;
+    }
+};
+
+struct SubtractOperation
+{
+    Color4f operator()(const Color4f& lhs, const Color4f& rhs) const
+    {
+        return lhs - rhs;
+    }
+};
+
+struct MultiplyOperation
+{
+    Color4f operator()(const Color4f& lhs, const Color4f& rhs) const
+    {
+        return lhs * rhs;
+    }
+};
+
+struct DivideOperation
+{
+    Color4f operator()(const Color4f& lhs, const Color4f& rhs) const
+    {
+        return lhs / rhs;
+    }
+};
+
+struct NegateOperation
+{
+    Color4f operator()(const Color4f& value) const
+    {
+        return -value;
+    }
+};
+
+struct ClampOperation
+{
+    Color4f operator()(const Color4f& value, const Color4f& lower, const Color4f& upper) const
+    {
+        return clamp(value, lower, upper);
+    }
+};
+
+struct LerpOperation
+{
+    Color4f operator()(const Color4f& from, const Color4f& to, const Color4f& weight) const
+    {
+        return from + (to - from) * weight;
+    }
+};
+
+struct SelectOperation
+{
+    Color4f operator()(const Color4f& mask, const Color4f& whenSet, const Color4f& whenUnset) const
+    {
+        Color4f result;
+        for(unsigned int channel = 0; channel < 4; ++channel)
+        {
+            result[channel] = mask[channel] != 0.0f ? whenSet[channel] : whenUnset[channel];
+        }
+        return result;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Expression applying an operation to each pixel of another expression
+ */
+template<class Operand, class Operation>
+class UnaryExpression: public ImageExpression<UnaryExpression<Operand, Operation>>
+{
+  public:
+    explicit UnaryExpression(const Operand& operand): m_operand(operand) {}
+
+    int width() const
+    {
+        return m_operand.width();
+    }
+
+    int height() const
+    {
+        return m_operand.height();
+    }
+
+    Color4f operator[](std::size_t index) const
+    {
+        return Operation{}(m_operand[index]);
+    }
+
+  private:
+    Operand m_operand;
+};
+
+/**
+ * @brief Expression combining the pixels of two expressions
+ */
+template<class Lhs, class Rhs, class Operation>
+class BinaryExpression: public ImageExpression<BinaryExpression<Lhs, Rhs, Operation>>
+{
+  public:
+    BinaryExpression(const Lhs& lhs, const Rhs& rhs):
+      m_lhs(lhs),
+      m_rhs(rhs),
+      m_width(detail::combineSize(lhs.width(), rhs.width())),
+      m_height(detail::combineSize(lhs.height(), rhs.height()))
+    {
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    Color4f operator[](std::size_t index) const
+    {
+        return Operation{}(m_lhs[index], m_rhs[index]);
+    }
+
+  private:
+    Lhs m_lhs;
+    Rhs m_rhs;
+    int m_width;
+    int m_height;
+};
+
+/**
+ * @brief Expression combining the pixels of three expressions
+ */
+template<class First, class Second, class Third, class Operation>
+class TernaryExpression: public ImageExpression<TernaryExpression<First, Second, Third, Operation>>
+{
+  public:
+    TernaryExpression(const First& first, const Second& second, const Third& third):
+      m_first(first),
+      m_second(second),
+      m_third(third),
+      m_width(detail::combineSize(detail::combineSize(first.width(), second.width()), third.width())),
+      m_height(detail::combineSize(detail::combineSize(first.height(), second.height()), third.height()))
+    {
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    Color4f operator[](std::size_t index) const
+    {
+        return Operation{}(m_first[index], m_second[index], m_third[index]);
+    }
+
+  private:
+    First m_first;
+    Second m_second;
+    Third m_third;
+    int m_width;
+    int m_height;
+};
+
+template<class Lhs, class Rhs, class Operation>
+using BinaryOperatorResult = typename std::enable_if<
+  detail::is_image_operand<Lhs>::value || detail::is_image_operand<Rhs>::value,
+  BinaryExpression<detail::expression_type<Lhs>, detail::expression_type<Rhs>, Operation>>::type;
+
+template<class First, class Second, class Third, class Operation>
+using TernaryFunctionResult = typename std::enable_if<
+  detail::is_image_operand<First>::value || detail::is_image_operand<Second>::value ||
+    detail::is_image_operand<Third>::value,
+  TernaryExpression<detail::expression_type<First>,
+                    detail::expression_type<Second>,
+                    detail::expression_type<Third>,
+                    Operation>>::type;
+
+/**
+ * @brief Add two operands pixel wise, operands are images, expressions, colors or numbers and one must be an image
+ * or an expression
+ */
+template<class Lhs, class Rhs>
+BinaryOperatorResult<Lhs, Rhs, detail::AddOperation> operator+(const Lhs& lhs, const Rhs& rhs)
+{
+    return {detail::makeExpression(lhs), detail::makeExpression(rhs)};
+}
+
+/**
+ * @brief Substract two operands pixel wise
+ */
+template<class Lhs, class Rhs>
+BinaryOperatorResult<Lhs, Rhs, detail::SubtractOperation> operator-(const Lhs& lhs, const Rhs& rhs)
+{
+    return {detail::makeExpression(lhs), detail::makeExpression(rhs)};
+}
+
+/**
+ * @brief Multiply two operands pixel wise
+ */
+template<class Lhs, class Rhs>
+BinaryOperatorResult<Lhs, Rhs, detail::MultiplyOperation> operator*(const Lhs& lhs, const Rhs& rhs)
+{
+    return {detail::makeExpression(lhs), detail::makeExpression(rhs)};
+}
+
+/**
+ * @brief Divide two operands pixel wise
+ */
+template<class Lhs, class Rhs>
+BinaryOperatorResult<Lhs, Rhs, detail::DivideOperation> operator/(const Lhs& lhs, const Rhs& rhs)
+{
+    return {detail::makeExpression(lhs), detail::makeExpression(rhs)};
+}
+
+/**
+ * @brief Negate an image or an expression
+ */
+template<class Operand>
+typename std::enable_if<detail::is_image_operand<Operand>::value,
+                        UnaryExpression<detail::expression_type<Operand>, detail::NegateOperation>>::type
+operator-(const Operand& operand)
+{
+    return UnaryExpression<detail::expression_type<Operand>, detail::NegateOperation>(
+      detail::makeExpression(operand));
+}
+
+/**
+ * @brief Clamp each channel between the channels of lower and upper
+ * @param[in] value The clamped operand
+ * @param[in] lower Lower bound, an image, an expression, a color or a number
+ * @param[in] upper Upper bound, an image, an expression, a color or a number
+ * @return The clamp expression
+ */
+template<class Value, class Lower, class Upper>
+TernaryFunctionResult<Value, Lower, Upper, detail::ClampOperation> clamp(const Value& value,
+                                                                         const Lower& lower,
+                                                                         const Upper& upper)
+{
+    return {detail::makeExpression(value), detail::makeExpression(lower), detail::makeExpression(upper)};
+}
+
+/**
+ * @brief Linear interpolation from + (to - from) * weight
+ * @param[in] from Operand given for a weight of 0
+ * @param[in] to Operand given for a weight of 1
+ * @param[in] weight Weight of each channel
+ * @return The interpolation expression
+ */
+template<class From, class To, class Weight>
+TernaryFunctionResult<From, To, Weight, detail::LerpOperation> lerp(const From& from,
+                                                                    const To& to,
+                                                                    const Weight& weight)
+{
+    return {detail::makeExpression(from), detail::makeExpression(to), detail::makeExpression(weight)};
+}
+
+/**
+ * @brief Pick each channel from whenSet if the channel of the mask is not 0, from whenUnset otherwise
+ * @param[in] mask The mask operand
+ * @param[in] whenSet Operand picked where the mask is set
+ * @param[in] whenUnset Operand picked where the mask is 0
+ * @return The selection expression
+ */
+template<class Mask, class WhenSet, class WhenUnset>
+TernaryFunctionResult<Mask, WhenSet, WhenUnset, detail::SelectOperation> select(const Mask& mask,
+                                                                                const WhenSet& whenSet,
+                                                                                const WhenUnset& whenUnset)
+{
+    return {detail::makeExpression(mask), detail::makeExpression(whenSet), detail::makeExpression(whenUnset)};
+}
+
+/**
+ * @brief Evaluate an expression into an image, each pixel is computed once in a single pass
+ * The destination may appear in the expression, it is resized if its dimensions differ from the expression ones.
+ * @param[in] expression The expression to evaluate
+ * @param[out] destination The image receiving the result
+ * @param[in] threadCount Maximum number of threads to use, 0 uses all the hardware threads
+ */
+template<class Expression>
+void evaluate(const ImageExpression<Expression>& expression, Image& destination, unsigned int threadCount = 1)
+{
+    const Expression& root = expression.derived();
+    if(root.width() < 0 || root.height() < 0)
+    {
+        throw std::invalid_argument("An expression made of constants only has no dimensions");
+    }
+    if(root.width() != destination.width() || root.height() != destination.height())
+    {
+        // The destination can't be resized in place as it may be read by the expression
+        Image result(root.width(), root.height());
+        evaluate(expression, result, threadCount);
+        destination = std::move(result);
+        return;
+    }
+
+    Color4f* output = destination.data();
+    const std::size_t size = static_cast<std::size_t>(root.width()) * static_cast<std::size_t>(root.height());
+    if(threadCount == 1)
+    {
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            output[index] = root[index];
+        }
+        return;
+    }
+    parallelFor(
+      0,
+      size,
+      16384,
+      [&root, output](std::size_t chunkBegin, std::size_t chunkEnd) {
+          for(std::size_t index = chunkBegin; index < chunkEnd; ++index)
+          {
+              output[index] = root[index];
+          }
+      },
+      threadCount);
+}
+
+template<class Expression>
+Image::Image(const ImageExpression<Expression>& expression)
+{
+    evaluate(expression, *this);
+}
+
+template<class Expression>
+Image& Image::operator=(const ImageExpression<Expression>& expression)
+{
+    evaluate(expression, *this);
+    return *this;
+}
+
+} // namespace stbipp
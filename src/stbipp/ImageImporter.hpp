@@ -1,11 +1,21 @@
 #pragma once
 #include "stbipp/Image.hpp"
+#include "stbipp/TypedImage.hpp"
 #include "stbipp/StbippSymbols.h"
 
 #include <string>
 
 namespace stbipp
 {
+/**
+ * @brief Decoder options used during load operation
+ */
+struct LoadOptions
+{
+    bool srgbToLinear{false};    /// Decode the color channels from sRGB to linear values, the alpha channel is kept
+    unsigned int threadCount{1}; /// Maximum number of threads converting the pixels, 0 uses all the hardware threads
+};
+
 /**
  * @brief Load an image at the given path with the given pixel format
  * Stbipp uses the same load function you'll find in stb_image meaning that you are able to load the same file format :
@@ -20,10 +30,29 @@ namespace stbipp
  * - PNM (.ppm and .pgm)
  * But it also contains the same limitations that you can find at :
  * https://github.com/nothings/stb/blob/master/stb_image.h
+ * The codec is picked through the CodecRegistry from the first bytes of the file, then from its extension. When no
+ * registered codec matches, stb_image still tries to decode the file.
+ * When options.srgbToLinear is set, the files decoded by stb_image go through sRGB lookup tables while their pixels
+ * are converted, 32 bits formats use the 16 bits table instead of the 2.2 gamma applied by stb_image. HDR files are
+ * already linear and are left unchanged. The images decoded by other codecs are converted afterwards.
  * @param[in] path Path to the image to load
  * @param[out] image The image which will contains the data (all contained data will be erased)
  * @param[in] pixelFormat The pixel format to use
+ * @param[in] options Decoder options
+ * @return true if the loading was successful
+ */
+STBIPP_API bool loadImage(const std::string& path,
+                          Image& image,
+                          const ImageFormat pixelFormat,
+                          const LoadOptions& options = LoadOptions{});
+
+/**
+ * @brief Load an image in half float RGBA storage
+ * HDR files are converted from the 32 bits floats decoded by stb_image straight to halves, other files are loaded
+ * as RGBA32 images first.
+ * @param[in] path Path to the image to load
+ * @param[out] image The image which will contains the data (all contained data will be erased)
  * @return true if the loading was successful
  */
-STBIPP_API bool loadImage(const std::string& path, Image& image, const ImageFormat pixelFormat);
+STBIPP_API bool loadImage(const std::string& path, HalfImage& image);
 } // namespace stbipp
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Rect.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief The IntegralImage class holds the summed area table of an image, to sum any rectangle of pixels in constant
+ * time
+ * Entry (x, y) of the table is the sum of the pixels above and on the left of pixel (x, y), the table has one more
+ * row and column than the image. The sums are accumulated in double precision, so they don't overflow and their
+ * rounding is negligible. They are sums of the float values stored by the image: 8 and 16 bits values are stored as
+ * rounded floats k / 255 and k / 65535 with a relative error up to 2^-24, so the sum of n pixels may differ from the
+ * exact sum of the fractions by up to n x 2^-24 times the largest value, e.g. 1 / 255 for 4096 x 4096 pixels of
+ * value 1 / 255.
+ */
+class STBIPP_API IntegralImage
+{
+  public:
+    /**
+     * @brief Default constructor, the table of an empty image
+     */
+    IntegralImage() = default;
+
+    /**
+     * @brief Build the summed area table of an image
+     * The rows are summed in bands over several threads, then the columns in blocks over several threads.
+     * @param[in] image The image to sum
+     * @param[in] squaredSums Also build the table of the squared values, needed by squaredSum and variance
+     * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+     */
+    explicit IntegralImage(const Image& image, bool squaredSums = false, unsigned int threadCount = 1);
+
+    /**
+     * @brief Width of the summed image
+     * @return The number of columns of the image
+     */
+    int width() const;
+
+    /**
+     * @brief Height of the summed image
+     * @return The number of rows of the image
+     */
+    int height() const;
+
+    /**
+     * @brief Check if the table of the squared values was built
+     * @return true if squaredSum and variance can be used
+     */
+    bool hasSquaredSums() const;
+
+    /**
+     * @brief Sum the pixels of a region
+     * @param[in] region The region, clipped to the image
+     * @return The sum of each channel, 0 for an empty region
+     */
+    Color4d sum(const Rect& region) const;
+
+    /**
+     * @brief Sum the squared values of the pixels of a region
+     * @param[in] region The region, clipped to the image
+     * @throw std::logic_error if the table of the squared values was not built
+     * @return The sum of the squares of each channel, 0 for an empty region
+     */
+    Color4d squaredSum(const Rect& region) const;
+
+    /**
+     * @brief Average the pixels of a region
+     * @param[in] region The region, clipped to the image
+     * @return The mean of each channel, 0 for an empty region
+     */
+    Color4f mean(const Rect& region) const;
+
+    /**
+     * @brief Compute the variance of the pixels of a region
+     * @param[in] region The region, clipped to the image
+     * @throw std::logic_error if the table of the squared values was not built
+     * @return The population variance of each channel, 0 for an empty region
+     */
+    Color4f variance(const Rect& region) const;
+
+    /**
+     * @brief Access the summed area table
+     * @return The (width + 1) x (height + 1) sums, row after row
+     */
+    const Color4d* data() const;
+
+  private:
+    /**
+     * @brief Sum the entries of a table over a region
+     */
+    Color4d sumTable(const std::vector<Color4d>& table, const Rect& region) const;
+
+    int m_width{0};
+    int m_height{0};
+    std::vector<Color4d> m_sums{};
+    std::vector<Color4d> m_squaredSums{};
+};
+
+} // namespace stbipp
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Resample.hpp"
+#include "stbipp/StbippSymbols.h"
+#include "stbipp/TypedImage.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief Settings of the mip chain generation
+ */
+struct MipChainOptions
+{
+    int levelCount{0};           /// Maximum number of levels including the source one, 0 builds the levels down to 1x1
+    bool gammaCorrect{false};    /// The colors are sRGB encoded and are filtered as linear values
+    bool alphaWeighted{false};   /// Colors are weighted by their alpha while filtered, transparent pixels don't bleed
+    unsigned int threadCount{1}; /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+namespace detail
+{
+/**
+ * @brief Store a row of a mip level
+ */
+using MipRowWriter = std::function<void(int level, int row, const Color4f* colors)>;
+
+/**
+ * @brief Compute the levels of a mip chain, used by buildMipChain
+ * Each level is resampled from the previous one, kept in 32 bits floats (linear and premultiplied by alpha if
+ * required), so the precision of the stored levels does not accumulate errors. The writer is called concurrently for
+ * different rows.
+ * @param[in] image The first level
+ * @param[in] filter The filter used to downscale each level
+ * @param[in] options The generation settings
+ * @param[in] levelCount Number of levels to compute, including the first one
+ * @param[in] writer Called once for each row of each level
+ */
+STBIPP_API void buildMipLevels(const Image& image,
+                               ResampleFilter filter,
+                               const MipChainOptions& options,
+                               int levelCount,
+                               const MipRowWriter& writer);
+} // namespace detail
+
+/**
+ * @brief Compute the number of levels of a full mip chain
+ * @param[in] width Width of the first level
+ * @param[in] height Height of the first level
+ * @return The number of levels down to 1x1, 0 for an empty image
+ */
+STBIPP_API int mipLevelCount(int width, int height);
+
+/**
+ * @brief The MipChain class stores all the levels of an image pyramid in a single allocation
+ * Each level is half the size of the previous one (rounded down, at least 1 pixel), the levels are stored one after
+ * the other from the largest to the smallest.
+ *
+ * @tparam ColorType The color type of the pixels (e.g : Color4uc for 8 bits textures)
+ */
+template<class ColorType>
+class MipChain
+{
+  public:
+    /**
+     * @brief Default mip chain constructor, the chain has no level
+     */
+    MipChain() = default;
+
+    /**
+     * @brief Mip chain constructor, allocate the levels
+     * @param[in] width Width of the first level
+     * @param[in] height Height of the first level
+     * @param[in] levelCount Number of levels, 0 allocates a full chain
+     */
+    MipChain(int width, int height, int levelCount = 0)
+    {
+        if(width < 0 || height < 0 || levelCount < 0)
+        {
+            throw std::invalid_argument("Mip chain dimensions and level count must be positive integers!");
+        }
+        const int fullLevelCount = mipLevelCount(width, height);
+        const int count = levelCount == 0 ? fullLevelCount : std::min(levelCount, fullLevelCount);
+        std::size_t size = 0;
+        for(int level = 0; level < count; ++level)
+        {
+            m_widths.push_back(std::max(width >> level, 1));
+            m_heights.push_back(std::max(height >> level, 1));
+            m_offsets.push_back(size);
+            size += static_cast<std::size_t>(m_widths.back()) * static_cast<std::size_t>(m_heights.back());
+        }
+        m_data.resize(size);
+    }
+
+    /**
+     * @brief Number of levels getter
+     * @return The number of levels
+     */
+    int levelCount() const
+    {
+        return static_cast<int>(m_offsets.size());
+    }
+
+    /**
+     * @brief Level width getter
+     * @param[in] level The level index, 0 is the largest level
+     * @return The width of the level
+     */
+    int width(int level) const
+    {
+        return m_widths[checkLevel(level)];
+    }
+
+    /**
+     * @brief Level height getter
+     * @param[in] level The level index, 0 is the largest level
+     * @return The height of the level
+     */
+    int height(int level) const
+    {
+        return m_heights[checkLevel(level)];
+    }
+
+    /**
+     * @brief Access the pixels of a level
+     * @param[in] level The level index, 0 is the largest level
+     * @return Pointer to the first pixel of the level
+     */
+    const ColorType* data(int level) const
+    {
+        return m_data.data() + m_offsets[checkLevel(level)];
+    }
+
+    /**
+     * @brief Access the pixels of a level
+     * @param[in] level The level index, 0 is the largest level
+     * @return Pointer to the first pixel of the level
+     */
+    ColorType* data(int level)
+    {
+        return m_data.data() + m_offsets[checkLevel(level)];
+    }
+
+    /**
+     * @brief Access the pixels of all the levels
+     * @return Pointer to the first pixel of the first level
+     */
+    const ColorType* data() const
+    {
+        return m_data.data();
+    }
+
+    /**
+     * @brief Number of pixels of all the levels
+     * @return The pixel count
+     */
+    std::size_t size() const
+    {
+        return m_data.size();
+    }
+
+    /**
+     * @brief Copy a level in an image
+     * @param[in] level The level index, 0 is the largest level
+     * @return The level pixels
+     */
+    TypedImage<ColorType> level(int level) const
+    {
+        TypedImage<ColorType> image(width(level), height(level));
+        const auto count = static_cast<std::size_t>(image.width()) * static_cast<std::size_t>(image.height());
+        copyPixels(data(level), image.data(), count);
+        return image;
+    }
+
+  private:
+    std::size_t checkLevel(int level) const
+    {
+        if(level < 0 || level >= levelCount())
+        {
+            throw std::out_of_range("Trying to access out of range mip level");
+        }
+        return static_cast<std::size_t>(level);
+    }
+
+    std::vector<ColorType> m_data;
+    std::vector<std::size_t> m_offsets;
+    std::vector<int> m_widths;
+    std::vector<int> m_heights;
+};
+
+/**
+ * @brief Build the mip chain of an image
+ * The first level is the image itself, each following level is downscaled from the previous one with the given filter.
+ * The rows of each level are computed by several threads, the levels themselves are computed one after the other
+ * since each one is read to compute the next.
+ * @param[in] image The first level
+ * @param[in] filter The filter used to downscale each level
+ * @param[in] options The generation settings
+ * @return The mip chain, converted to ColorType while the levels are written
+ */
+template<class ColorType = Color4f>
+MipChain<ColorType> buildMipChain(const Image& image,
+                                  ResampleFilter filter = ResampleFilter::BOX,
+                                  const MipChainOptions& options = MipChainOptions{})
+{
+    MipChain<ColorType> chain(image.width(), image.height(), options.levelCount);
+    detail::buildMipLevels(
+      image, filter, options, chain.levelCount(), [&chain](int level, int row, const Color4f* colors) {
+          const auto width = static_cast<std::size_t>(chain.width(level));
+          convertPixels(colors, chain.data(level) + width * static_cast<std::size_t>(row), width);
+      });
+    return chain;
+}
+
+} // namespace stbipp
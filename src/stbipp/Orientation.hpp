@@ -0,0 +1,191 @@
+#pragma once
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace stbipp
+{
+namespace detail
+{
+// Side of the square tiles copied by the rotations, the source and destination tiles of 16 bytes pixels fit in the
+// L1 cache together
+constexpr int orientationTileSize = 32;
+// Number of pixels processed by each task of the flips
+constexpr std::size_t orientationGrainSize = 16384;
+
+/**
+ * @brief Copy the pixels of an image to a destination whose rows are the columns of the source
+ * Destination pixel (x, y) reads the source pixel at column y (width - 1 - y if mirrorColumns) and row x
+ * (height - 1 - x if mirrorRows). The destination is processed in square tiles, so the source rows read by a tile stay
+ * in the cache, and the bands of tiles are spread over several threads.
+ * @param[in] source The source image
+ * @param[out] destination An image of height x width pixels
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+template<bool mirrorColumns, bool mirrorRows, class ImageType>
+void copyTransposed(const ImageType& source, ImageType& destination, unsigned int threadCount)
+{
+    const int sourceWidth = source.width();
+    const int sourceHeight = source.height();
+    const auto* input = source.data();
+    auto* output = destination.data();
+    const auto inputRowSize = static_cast<std::size_t>(sourceWidth);
+    const auto outputRowSize = static_cast<std::size_t>(sourceHeight);
+    const int tileSize = orientationTileSize;
+    const int bandCount = (sourceWidth + tileSize - 1) / tileSize;
+    parallelFor(
+      0,
+      static_cast<std::size_t>(bandCount),
+      1,
+      [&](std::size_t bandBegin, std::size_t bandEnd) {
+          for(std::size_t band = bandBegin; band < bandEnd; ++band)
+          {
+              const int rowBegin = static_cast<int>(band) * tileSize;
+              const int rowEnd = std::min(rowBegin + tileSize, sourceWidth);
+              for(int columnBegin = 0; columnBegin < sourceHeight; columnBegin += tileSize)
+              {
+                  const int columnEnd = std::min(columnBegin + tileSize, sourceHeight);
+                  for(int row = rowBegin; row < rowEnd; ++row)
+                  {
+                      const int sourceColumn = mirrorColumns ? sourceWidth - 1 - row : row;
+                      const auto* sourcePixels = input + static_cast<std::size_t>(sourceColumn);
+                      auto* destinationRow = output + static_cast<std::size_t>(row) * outputRowSize;
+                      for(int column = columnBegin; column < columnEnd; ++column)
+                      {
+                          const int sourceRow = mirrorRows ? sourceHeight - 1 - column : column;
+                          destinationRow[column] = sourcePixels[static_cast<std::size_t>(sourceRow) * inputRowSize];
+                      }
+                  }
+              }
+          }
+      },
+      threadCount);
+}
+} // namespace detail
+
+/**
+ * @brief Flip an image upside down in place, the rows are swapped over several threads
+ * @param[in,out] image The image to flip, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+template<class ImageType>
+void flipVertical(ImageType& image, unsigned int threadCount = 1)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    const auto height = static_cast<std::size_t>(image.height());
+    auto* pixels = image.data();
+    parallelFor(
+      0,
+      height / 2,
+      std::max<std::size_t>(1, detail::orientationGrainSize / std::max<std::size_t>(width, 1)),
+      [=](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              auto* top = pixels + row * width;
+              std::swap_ranges(top, top + width, pixels + (height - 1 - row) * width);
+          }
+      },
+      threadCount);
+}
+
+/**
+ * @brief Mirror an image from left to right in place, the rows are reversed over several threads
+ * @param[in,out] image The image to flip, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+template<class ImageType>
+void flipHorizontal(ImageType& image, unsigned int threadCount = 1)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    auto* pixels = image.data();
+    parallelFor(
+      0,
+      static_cast<std::size_t>(image.height()),
+      std::max<std::size_t>(1, detail::orientationGrainSize / std::max<std::size_t>(width, 1)),
+      [=](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              std::reverse(pixels + row * width, pixels + (row + 1) * width);
+          }
+      },
+      threadCount);
+}
+
+/**
+ * @brief Rotate an image by 180 degrees in place
+ * @param[in,out] image The image to rotate, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+template<class ImageType>
+void rotate180(ImageType& image, unsigned int threadCount = 1)
+{
+    const auto width = static_cast<std::size_t>(image.width());
+    const auto height = static_cast<std::size_t>(image.height());
+    auto* pixels = image.data();
+    // Each task swaps the reversed rows of both halves, the middle row of an odd height is reversed alone
+    parallelFor(
+      0,
+      (height + 1) / 2,
+      std::max<std::size_t>(1, detail::orientationGrainSize / std::max<std::size_t>(width, 1)),
+      [=](std::size_t begin, std::size_t end) {
+          for(std::size_t row = begin; row < end; ++row)
+          {
+              auto* top = pixels + row * width;
+              auto* bottom = pixels + (height - 1 - row) * width;
+              if(top == bottom)
+              {
+                  std::reverse(top, top + width);
+                  continue;
+              }
+              std::swap_ranges(top, top + width, std::reverse_iterator<decltype(bottom)>(bottom + width));
+          }
+      },
+      threadCount);
+}
+
+/**
+ * @brief Swap the rows and the columns of an image
+ * @param[in] image The image to transpose, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @return The transposed image, of height x width pixels
+ */
+template<class ImageType>
+ImageType transpose(const ImageType& image, unsigned int threadCount = 1)
+{
+    ImageType result(image.height(), image.width());
+    detail::copyTransposed<false, false>(image, result, threadCount);
+    return result;
+}
+
+/**
+ * @brief Rotate an image by 90 degrees clockwise
+ * @param[in] image The image to rotate, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @return The rotated image, of height x width pixels
+ */
+template<class ImageType>
+ImageType rotate90(const ImageType& image, unsigned int threadCount = 1)
+{
+    ImageType result(image.height(), image.width());
+    detail::copyTransposed<false, true>(image, result, threadCount);
+    return result;
+}
+
+/**
+ * @brief Rotate an image by 90 degrees counterclockwise (270 degrees clockwise)
+ * @param[in] image The image to rotate, an Image or a TypedImage
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @return The rotated image, of height x width pixels
+ */
+template<class ImageType>
+ImageType rotate270(const ImageType& image, unsigned int threadCount = 1)
+{
+    ImageType result(image.height(), image.width());
+    detail::copyTransposed<true, false>(image, result, threadCount);
+    return result;
+}
+
+} // namespace stbipp
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "stbipp/StbippSymbols.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace stbipp
+{
+/**
+ * @brief Retrieve the number of threads used when a thread count of 0 is requested
+ * @return The number of hardware threads, at least 1
+ */
+STBIPP_API unsigned int hardwareThreadCount();
+
+/**
+ * @brief Timing of a chunk of a parallel loop, reported to the TaskObserver of a ThreadPool
+ */
+struct TaskTiming
+{
+    std::size_t begin;                            /// First index of the chunk
+    std::size_t end;                              /// Index following the last index of the chunk
+    int workerIndex;                              /// Index of the pool worker which ran the chunk, -1 for other threads
+    std::chrono::steady_clock::duration duration; /// Time spent in the body
+};
+
+/**
+ * @brief Called after each chunk of the parallel loops of a ThreadPool, possibly from several threads at once
+ */
+using TaskObserver = std::function<void(const TaskTiming& timing)>;
+
+/**
+ * @brief The ThreadPool class runs the parallel loops of the library on a fixed set of worker threads
+ * Each worker owns a queue of tasks, it runs its own tasks first and steals the tasks of the other workers when its
+ * queue is empty. A thread waiting for a parallel loop runs the pending tasks meanwhile, so a loop body may start
+ * another parallel loop (nested parallelism) without blocking the workers.
+ */
+class STBIPP_API ThreadPool
+{
+  public:
+    /**
+     * @brief Thread pool constructor, start the workers
+     * @param[in] workerCount Number of worker threads, the thread calling parallelFor also runs chunks so 0 is valid
+     */
+    explicit ThreadPool(unsigned int workerCount);
+
+    /**
+     * @brief Thread pool destructor, wait for the pending tasks then join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Retrieve the pool shared by all the operations of the library
+     * It is created on first use with hardwareThreadCount() - 1 workers.
+     * @return The global pool
+     */
+    static ThreadPool& global();
+
+    /**
+     * @brief Number of worker threads getter
+     * @return The number of workers
+     */
+    unsigned int workerCount() const;
+
+    /**
+     * @brief Process the [begin, end) range in chunks of grainSize indices spread over the workers
+     * Chunks are distributed dynamically, so the body must not rely on the order in which they are processed.
+     * If the body throws, the remaining chunks are skipped and the first exception is rethrown in the calling thread.
+     * @param[in] begin First index of the range
+     * @param[in] end Index following the last index of the range
+     * @param[in] grainSize Number of indices processed by each call to body (0 is treated as 1)
+     * @param[in] body Function called with the bounds [chunkBegin, chunkEnd) of each chunk
+     * @param[in] threadCount Maximum number of threads running chunks, including the calling one. 0 uses all the
+     * workers, the count is limited to workerCount() + 1.
+     */
+    void parallelFor(std::size_t begin,
+                     std::size_t end,
+                     std::size_t grainSize,
+                     const std::function<void(std::size_t, std::size_t)>& body,
+                     unsigned int threadCount = 0);
+
+    /**
+     * @brief Set the function receiving the timing of each chunk of the following parallel loops
+     * @param[in] observer The observer, an empty function disables the timing
+     */
+    void setTaskObserver(TaskObserver observer);
+
+  private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+
+/**
+ * @brief Process the [begin, end) range in chunks of grainSize indices spread over the threads of the global pool
+ * Chunks are distributed dynamically, so the body must not rely on the order in which they are processed.
+ * If the body throws, the remaining chunks are skipped and the first exception is rethrown in the calling thread.
+ * @param[in] begin First index of the range
+ * @param[in] end Index following the last index of the range
+ * @param[in] grainSize Number of indices processed by each call to body (0 is treated as 1)
+ * @param[in] body Function called with the bounds [chunkBegin, chunkEnd) of each chunk
+ * @param[in] threadCount Maximum number of threads to use, 0 uses all the hardware threads
+ */
+STBIPP_API void parallelFor(std::size_t begin,
+                            std::size_t end,
+                            std::size_t grainSize,
+                            const std::function<void(std::size_t, std::size_t)>& body,
+                            unsigned int threadCount = 0);
+
+/**
+ * @brief Process a width x height area in tiles spread over the threads of the global pool
+ * @param[in] width Width of the area
+ * @param[in] height Height of the area
+ * @param[in] tileWidth Width of the tiles (0 is treated as 1)
+ * @param[in] tileHeight Height of the tiles (0 is treated as 1)
+ * @param[in] body Function called with the bounds [x0, x1) and [y0, y1) of each tile
+ * @param[in] threadCount Maximum number of threads to use, 0 uses all the hardware threads
+ */
+STBIPP_API void parallelForTiles(int width,
+                                 int height,
+                                 int tileWidth,
+                                 int tileHeight,
+                                 const std::function<void(int x0, int y0, int x1, int y1)>& body,
+                                 unsigned int threadCount = 0);
+
+/**
+ * @brief The Executor class decides how the chunks of a range of indices are run
+ * The pixel algorithms take an executor so the same code can run serially, over the library threads or over a
+ * scheduler provided by the caller.
+ */
+class STBIPP_API Executor
+{
+  public:
+    using Body = std::function<void(std::size_t, std::size_t)>;
+    using Function =
+      std::function<void(std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body)>;
+
+    /**
+     * @brief Executor constructor, wrap a user scheduler
+     * @param[in] function Called with the range, the grain size and the body to call for each chunk of the range. It
+     * must have called the body for every index of the range before returning.
+     * @throw std::invalid_argument if function is empty
+     */
+    explicit Executor(Function function);
+
+    /**
+     * @brief Create an executor running all the chunks in the calling thread
+     * @return The executor
+     */
+    static Executor serial();
+
+    /**
+     * @brief Create an executor spreading the chunks over the global pool with parallelFor
+     * @param[in] threadCount Maximum number of threads to use, 0 uses all the hardware threads
+     * @return The executor
+     */
+    static Executor parallel(unsigned int threadCount = 0);
+
+    /**
+     * @brief Create an executor spreading the chunks over the workers of a pool
+     * @param[in] pool The pool, it must outlive the executor
+     * @param[in] threadCount Maximum number of threads to use, 0 uses all the workers
+     * @return The executor
+     */
+    static Executor pool(ThreadPool& pool, unsigned int threadCount = 0);
+
+    /**
+     * @brief Process the [begin, end) range in chunks of grainSize indices
+     * @param[in] begin First index of the range
+     * @param[in] end Index following the last index of the range
+     * @param[in] grainSize Number of indices processed by each call to body (0 is treated as 1)
+     * @param[in] body Function called with the bounds [chunkBegin, chunkEnd) of each chunk
+     */
+    void run(std::size_t begin, std::size_t end, std::size_t grainSize, const Body& body) const;
+
+  private:
+    Function m_function;
+};
+
+} // namespace stbipp
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "stbipp/Parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace stbipp
+{
+namespace detail
+{
+// Number of pixels processed by each chunk, small enough to balance pixels with uneven costs between the threads
+constexpr std::size_t pixelGrainSize = 4096;
+
+/**
+ * @brief Run a function over the row bands of an image with an executor
+ * @param[in] width Width of the image
+ * @param[in] height Height of the image
+ * @param[in] executor Runs the row bands
+ * @param[in] body Function called with the bounds [rowBegin, rowEnd) of each band
+ */
+inline void forEachRowBand(int width, int height, const Executor& executor, const Executor::Body& body)
+{
+    if(width <= 0 || height <= 0)
+    {
+        return;
+    }
+    const auto rowCount = std::max<std::size_t>(1, pixelGrainSize / static_cast<std::size_t>(width));
+    executor.run(0, static_cast<std::size_t>(height), rowCount, body);
+}
+} // namespace detail
+
+/**
+ * @brief Call a function for each pixel of an image
+ * The rows are split in bands run by the executor, the function must be safe to call concurrently when the executor
+ * uses several threads.
+ * @param[in,out] image The image, an Image or a TypedImage
+ * @param[in] function Called as function(x, y, color) with a reference to the pixel color
+ * @param[in] executor Runs the row bands, serial by default
+ */
+template<class ImageType, class Function>
+void forEachPixel(ImageType& image, Function function, const Executor& executor = Executor::serial())
+{
+    const int width = image.width();
+    auto* pixels = image.data();
+    detail::forEachRowBand(width, image.height(), executor, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        for(std::size_t row = rowBegin; row < rowEnd; ++row)
+        {
+            auto* rowPixels = pixels + row * static_cast<std::size_t>(width);
+            for(int column = 0; column < width; ++column)
+            {
+                function(column, static_cast<int>(row), rowPixels[column]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Set each pixel of an image to the value returned by a function
+ * @param[in,out] image The image to fill, an Image or a TypedImage
+ * @param[in] function Called as function(x, y), returns the color of the pixel
+ * @param[in] executor Runs the row bands, serial by default
+ */
+template<class ImageType, class Function>
+void generate(ImageType& image, Function function, const Executor& executor = Executor::serial())
+{
+    const int width = image.width();
+    auto* pixels = image.data();
+    detail::forEachRowBand(width, image.height(), executor, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        for(std::size_t row = rowBegin; row < rowEnd; ++row)
+        {
+            auto* rowPixels = pixels + row * static_cast<std::size_t>(width);
+            for(int column = 0; column < width; ++column)
+            {
+                rowPixels[column] = function(column, static_cast<int>(row));
+            }
+        }
+    });
+}
+
+/**
+ * @brief Store the result of a function applied to each pixel of an image in another image
+ * The destination may be the source image, it is reallocated if its dimensions differ from the source ones.
+ * @param[in] source The image to read, an Image or a TypedImage
+ * @param[out] destination The image receiving the results, an Image or a TypedImage of any color type
+ * @param[in] function Called as function(color) with each source color, returns the destination color
+ * @param[in] executor Runs the row bands, serial by default
+ */
+template<class SourceImage, class DestinationImage, class Function>
+void transform(const SourceImage& source,
+               DestinationImage& destination,
+               Function function,
+               const Executor& executor = Executor::serial())
+{
+    if(source.width() != destination.width() || source.height() != destination.height())
+    {
+        destination = DestinationImage(source.width(), source.height());
+    }
+    const auto* input = source.data();
+    auto* output = destination.data();
+    const auto width = static_cast<std::size_t>(source.width());
+    detail::forEachRowBand(source.width(), source.height(), executor, [&](std::size_t rowBegin, std::size_t rowEnd) {
+        for(std::size_t index = rowBegin * width; index < rowEnd * width; ++index)
+        {
+            output[index] = function(input[index]);
+        }
+    });
+}
+
+} // namespace stbipp
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace stbipp
+{
+/**
+ * @brief A position in an image, in pixels, the center of pixel (x, y) is at integer coordinates (x, y)
+ */
+struct Point2f
+{
+    float x{0.0f}; /// Horizontal coordinate, growing to the right
+    float y{0.0f}; /// Vertical coordinate, growing downwards
+
+    /**
+     * @brief Default point constructor, the origin
+     */
+    Point2f() = default;
+
+    /**
+     * @brief Point constructor
+     * @param[in] x Horizontal coordinate
+     * @param[in] y Vertical coordinate
+     */
+    Point2f(float x, float y): x(x), y(y) {}
+};
+
+} // namespace stbipp
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "stbipp/StbippSymbols.h"
+
+#include <memory>
+#include <string>
+
+namespace stbipp
+{
+/**
+ * @brief The QoiWriter class writes a QOI (Quite OK Image) file row by row
+ * The rows are compressed and written as they are given, so the whole image never has to be in memory.
+ */
+class STBIPP_API QoiWriter
+{
+  public:
+    /**
+     * @brief Create the file and write the QOI header
+     * @param[in] path Path to the file to write
+     * @param[in] width Image width
+     * @param[in] height Image height
+     * @param[in] channels Number of channels of the rows, 3 (RGB) or 4 (RGBA)
+     * @param[in] linear true if all the channels are linear, false if the colors are sRGB encoded
+     */
+    QoiWriter(const std::string& path, int width, int height, int channels, bool linear = false);
+
+    /**
+     * @brief Close the file if close was not called
+     */
+    ~QoiWriter();
+
+    QoiWriter(const QoiWriter&) = delete;
+    QoiWriter& operator=(const QoiWriter&) = delete;
+
+    /**
+     * @brief Check if the file was created and the parameters are valid
+     * @return true if rows can be written
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Compress and write the next row
+     * @param[in] row Pointer to width * channels values
+     * @return true if the row was written, false if the writer is not open or all the rows were already written
+     */
+    bool writeRow(const unsigned char* row);
+
+    /**
+     * @brief Write the end of the file and close it
+     * @return true if all the rows were written and the file was closed without error
+     */
+    bool close();
+
+  private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+
+/**
+ * @brief The QoiReader class reads a QOI (Quite OK Image) file row by row
+ */
+class STBIPP_API QoiReader
+{
+  public:
+    /**
+     * @brief Open the file and read the QOI header
+     * @param[in] path Path to the file to read
+     */
+    explicit QoiReader(const std::string& path);
+
+    ~QoiReader();
+
+    QoiReader(const QoiReader&) = delete;
+    QoiReader& operator=(const QoiReader&) = delete;
+
+    /**
+     * @brief Check if the file was opened and has a valid QOI header
+     * @return true if rows can be read
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Image width getter
+     * @return The image width
+     */
+    int width() const;
+
+    /**
+     * @brief Image height getter
+     * @return The image height
+     */
+    int height() const;
+
+    /**
+     * @brief Number of channels stored in the file
+     * @return 3 (RGB) or 4 (RGBA)
+     */
+    int channels() const;
+
+    /**
+     * @brief Check if the colors stored in the file are linear
+     * @return true if all the channels are linear, false if the colors are sRGB encoded
+     */
+    bool isLinear() const;
+
+    /**
+     * @brief Decode the next row
+     * @param[out] row Pointer to width * channels() values
+     * @return true if the row was read, false if the file is truncated, corrupted or all the rows were already read
+     */
+    bool readRow(unsigned char* row);
+
+  private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+
+} // namespace stbipp
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "stbipp/Image.hpp"
+#include "stbipp/ImageFormat.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace stbipp
+{
+class MappedImage;
+
+/**
+ * @brief Save an image in the raw stbipp format
+ * The pixels are stored uncompressed with a CRC-32 checksum, in the byte order of the machine writing them.
+ * @param[in] path Path to the file to write
+ * @param[in] image The image containing the data to save
+ * @param[in] pixelFormat The format of the stored pixels, values are clamped to [0, 1] for integer formats
+ * @return true if the save operation was successful
+ */
+STBIPP_API bool saveRaw(const std::string& path,
+                        const Image& image,
+                        const ImageFormat pixelFormat = ImageFormat::RGBA32);
+
+/**
+ * @brief Map a raw stbipp file in memory
+ * @param[in] path Path to the file to load
+ * @param[out] image The view on the file (a previously mapped file is released)
+ * @param[in] verifyChecksum Read all the pixels to check the file checksum, this gives up the benefit of the lazy
+ * loading of the mapping
+ * @return true if the file was mapped successfully
+ */
+STBIPP_API bool loadRaw(const std::string& path, MappedImage& image, bool verifyChecksum = false);
+
+/**
+ * @brief The MappedImage class is a read only view on the pixels of a raw stbipp file mapped in memory
+ * Raw stbipp files store a small header followed by the uncompressed pixels, each row starting on a 64 bytes boundary.
+ * Loading one maps the file in memory without copying or parsing the pixels, they are only read from the disk when
+ * accessed. The view stays valid as long as the MappedImage lives.
+ */
+class STBIPP_API MappedImage
+{
+  public:
+    /**
+     * @brief Create an invalid view, use loadRaw to map a file
+     */
+    MappedImage();
+
+    /**
+     * @brief Unmap the file
+     */
+    ~MappedImage();
+
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    /**
+     * @brief MappedImage move constructor
+     * @param[in] other The view moved, invalid afterwards
+     */
+    MappedImage(MappedImage&& other) noexcept;
+
+    /**
+     * @brief Move operator
+     * @param[in] other The view moved, invalid afterwards
+     * @return A reference to the view
+     */
+    MappedImage& operator=(MappedImage&& other) noexcept;
+
+    /**
+     * @brief Check if a file is mapped
+     * @return true if the view can be accessed
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Image width getter
+     * @return The image width
+     */
+    int width() const;
+
+    /**
+     * @brief Image height getter
+     * @return The image height
+     */
+    int height() const;
+
+    /**
+     * @brief The format of the stored pixels
+     * @return The pixel format
+     */
+    ImageFormat pixelFormat() const;
+
+    /**
+     * @brief Number of bytes between the beginning of two consecutive rows
+     * @return The row pitch
+     */
+    std::size_t rowPitch() const;
+
+    /**
+     * @brief Access the raw data of a row
+     * @param[in] row The y coordinate
+     * @return Pointer to the first pixel of the row
+     */
+    const void* rowData(int row) const;
+
+    /**
+     * @brief Access the pixels of a row
+     * @tparam ColorType Color type matching the pixel format (e.g : Color4f for RGBA32, Color3uc for RGB8)
+     * @param[in] row The y coordinate
+     * @return Pointer to the first pixel of the row
+     */
+    template<class ColorType>
+    const ColorType* row(int row) const
+    {
+        using DataType = typename ColorType::data_type;
+        const ImageFormat format = pixelFormat();
+        const bool sameDepth = (std::is_same<DataType, unsigned char>::value && isFormat8Bits(format)) ||
+                               (std::is_same<DataType, unsigned short>::value && isFormat16Bits(format)) ||
+                               (std::is_same<DataType, float>::value && isFormat32Bits(format));
+        if(!sameDepth || static_cast<int>(ColorType{}.size()) != formatChannelCount(format))
+        {
+            throw std::invalid_argument("The color type does not match the mapped pixel format");
+        }
+        return static_cast<const ColorType*>(rowData(row));
+    }
+
+    /**
+     * @brief Copy the pixels into an image
+     * @return The image
+     */
+    Image toImage() const;
+
+  private:
+    friend bool loadRaw(const std::string& path, MappedImage& image, bool verifyChecksum);
+
+    struct Mapping;
+    std::unique_ptr<Mapping> m_mapping;
+};
+
+} // namespace stbipp
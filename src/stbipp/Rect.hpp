@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+
+namespace stbipp
+{
+/**
+ * @brief An axis aligned region of an image, in pixels
+ */
+struct Rect
+{
+    int x{0};      /// Column of the top left pixel
+    int y{0};      /// Row of the top left pixel
+    int width{0};  /// Number of columns
+    int height{0}; /// Number of rows
+
+    /**
+     * @brief Default region constructor, the region is empty
+     */
+    Rect() = default;
+
+    /**
+     * @brief Region constructor
+     * @param[in] x Column of the top left pixel
+     * @param[in] y Row of the top left pixel
+     * @param[in] width Number of columns
+     * @param[in] height Number of rows
+     */
+    Rect(int x, int y, int width, int height): x(x), y(y), width(width), height(height) {}
+
+    /**
+     * @brief Check if the region contains no pixel
+     * @return true if the width or the height is not positive
+     */
+    bool isEmpty() const
+    {
+        return width <= 0 || height <= 0;
+    }
+};
+
+/**
+ * @brief Compute the overlap of two regions
+ * @param[in] lhs The first region
+ * @param[in] rhs The second region
+ * @return The pixels in both regions, an empty region if they don't overlap
+ */
+inline Rect intersect(const Rect& lhs, const Rect& rhs)
+{
+    const int left = std::max(lhs.x, rhs.x);
+    const int top = std::max(lhs.y, rhs.y);
+    const int right = std::min(lhs.x + lhs.width, rhs.x + rhs.width);
+    const int bottom = std::min(lhs.y + lhs.height, rhs.y + rhs.height);
+    return Rect{left, top, std::max(right - left, 0), std::max(bottom - top, 0)};
+}
+
+} // namespace stbipp
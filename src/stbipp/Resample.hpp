@@ -0,0 +1,118 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+#include "stbipp/TypedImage.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace stbipp
+{
+/**
+ * @brief The filter used to compute each resampled pixel from the source pixels around it
+ */
+enum class ResampleFilter
+{
+    BOX,      /// Average of the covered pixels, nearest pixel when upscaling
+    BILINEAR, /// Triangle filter, linear interpolation when upscaling
+    BICUBIC,  /// Catmull-Rom cubic spline, sharp and interpolating
+    MITCHELL, /// Mitchell-Netravali cubic (B = C = 1/3), good trade-off between blur and ringing
+    LANCZOS3  /// Windowed sinc with 3 lobes, sharpest but rings around hard edges
+};
+
+namespace detail
+{
+/**
+ * @brief Give access to a source row, either the row itself or the given buffer filled with its colors
+ */
+using ResampleRowReader = std::function<const Color4f*(int row, Color4f* buffer)>;
+
+/**
+ * @brief Store a resampled row in the destination image
+ */
+using ResampleRowWriter = std::function<void(int row, const Color4f* colors)>;
+
+/**
+ * @brief Resample an image given row by row, used by the resample functions
+ * The rows are first resampled horizontally then vertically, both passes use precomputed weight tables and are split
+ * in row bands over several threads, so the reader and the writer are called concurrently for different rows.
+ * @param[in] sourceWidth Width of the source image
+ * @param[in] sourceHeight Height of the source image
+ * @param[in] width Width of the resampled image
+ * @param[in] height Height of the resampled image
+ * @param[in] filter The resampling filter
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @param[in] reader Called once for each source row
+ * @param[in] writer Called once for each resampled row
+ */
+STBIPP_API void resampleRows(int sourceWidth,
+                             int sourceHeight,
+                             int width,
+                             int height,
+                             ResampleFilter filter,
+                             unsigned int threadCount,
+                             const ResampleRowReader& reader,
+                             const ResampleRowWriter& writer);
+} // namespace detail
+
+/**
+ * @brief Resample an image to new dimensions
+ * The filter is widened when downscaling so every source pixel contributes, the pixels outside the image repeat the
+ * border ones. Colors are filtered as they are stored, convert sRGB images to linear values first for gamma correct
+ * results (see srgbToLinear).
+ * @param[in] image The image to resample
+ * @param[in] width Width of the resampled image
+ * @param[in] height Height of the resampled image
+ * @param[in] filter The resampling filter
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @throw std::invalid_argument if the dimensions are negative, or if the image is empty and the result is not
+ * @return The resampled image
+ */
+STBIPP_API Image resample(const Image& image,
+                          int width,
+                          int height,
+                          ResampleFilter filter = ResampleFilter::MITCHELL,
+                          unsigned int threadCount = 1);
+
+/**
+ * @brief Resample a typed image to new dimensions, see the Image version
+ * Rows are converted to Color4f while they are read and back when they are written, integer channels are rounded and
+ * clamped to their range.
+ * @param[in] image The image to resample
+ * @param[in] width Width of the resampled image
+ * @param[in] height Height of the resampled image
+ * @param[in] filter The resampling filter
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @throw std::invalid_argument if the dimensions are negative, or if the image is empty and the result is not
+ * @return The resampled image
+ */
+template<class ColorType>
+TypedImage<ColorType> resample(const TypedImage<ColorType>& image,
+                               int width,
+                               int height,
+                               ResampleFilter filter = ResampleFilter::MITCHELL,
+                               unsigned int threadCount = 1)
+{
+    TypedImage<ColorType> result(width, height);
+    const auto sourceWidth = static_cast<std::size_t>(image.width());
+    const auto resultWidth = static_cast<std::size_t>(width);
+    detail::resampleRows(
+      image.width(),
+      image.height(),
+      width,
+      height,
+      filter,
+      threadCount,
+      [&image, sourceWidth](int row, Color4f* buffer) {
+          convertPixels(image.data() + sourceWidth * static_cast<std::size_t>(row), buffer, sourceWidth);
+          return static_cast<const Color4f*>(buffer);
+      },
+      [&result, resultWidth](int row, const Color4f* colors) {
+          convertPixels(colors, result.data() + resultWidth * static_cast<std::size_t>(row), resultWidth);
+      });
+    return result;
+}
+
+} // namespace stbipp
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "stbipp/BorderMode.hpp"
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Point.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <cstddef>
+
+namespace stbipp
+{
+/**
+ * @brief The filter interpolating the pixels around a sampled position
+ */
+enum class SampleFilter
+{
+    NEAREST,  /// Closest pixel
+    BILINEAR, /// Linear interpolation of the 2x2 closest pixels
+    BICUBIC   /// Catmull-Rom interpolation of the 4x4 closest pixels, sharper but may overshoot
+};
+
+/**
+ * @brief Settings of the sampling
+ */
+struct SampleOptions
+{
+    SampleFilter filter{SampleFilter::BILINEAR}; /// Interpolation filter
+    BorderMode border{BorderMode::CLAMP};        /// How the pixels outside the image are read
+    Color4f borderColor{};                       /// Color of the pixels outside the image with BorderMode::CONSTANT
+    unsigned int threadCount{1};                 /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Interpolate an image at a position
+ * The center of pixel (x, y) is at integer coordinates (x, y), so sampling integer coordinates inside the image gives
+ * the pixel values.
+ * @param[in] image The image to sample
+ * @param[in] x Horizontal position in pixels
+ * @param[in] y Vertical position in pixels
+ * @param[in] filter Interpolation filter
+ * @param[in] border How the pixels outside the image are read
+ * @param[in] borderColor Color of the pixels outside the image with BorderMode::CONSTANT
+ * @return The interpolated color, the border color for NaN positions and empty images
+ */
+STBIPP_API Color4f sample(const Image& image,
+                          float x,
+                          float y,
+                          SampleFilter filter = SampleFilter::BILINEAR,
+                          BorderMode border = BorderMode::CLAMP,
+                          const Color4f& borderColor = Color4f{});
+
+/**
+ * @brief Interpolate an image at many positions
+ * The points are split in chunks over several threads. The filter and the border mode are selected once for all the
+ * points, and the pixels of the positions far enough from the borders are read without border handling.
+ * @param[in] image The image to sample
+ * @param[in] points First position, with the conventions of sample
+ * @param[in] count Number of positions
+ * @param[out] colors First interpolated color written, count colors are written
+ * @param[in] options Filter, border mode and thread count
+ */
+STBIPP_API void sampleMany(const Image& image,
+                           const Point2f* points,
+                           std::size_t count,
+                           Color4f* colors,
+                           const SampleOptions& options = SampleOptions{});
+
+} // namespace stbipp
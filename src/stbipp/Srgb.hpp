@@ -0,0 +1,94 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace stbipp
+{
+/**
+ * @brief Decode an sRGB encoded value to a linear value with the exact sRGB transfer function
+ * @param[in] value The sRGB value, values outside [0, 1] follow the same curve
+ * @return The linear value
+ */
+inline float srgbToLinear(float value)
+{
+    return value > 0.04045f ? std::pow((value + 0.055f) / 1.055f, 2.4f) : value / 12.92f;
+}
+
+/**
+ * @brief Encode a linear value to an sRGB value with the exact sRGB transfer function
+ * @param[in] value The linear value, values outside [0, 1] follow the same curve
+ * @return The sRGB value
+ */
+inline float linearToSrgb(float value)
+{
+    return value > 0.0031308f ? 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f : value * 12.92f;
+}
+
+/**
+ * @brief Decode interleaved 8 bits sRGB channels to linear colors through a lookup table
+ * The alpha channel of 2 and 4 channels pixels is only normalized, the missing channels are set to 0.
+ * @param[in] source The channels of each pixel, one after the other
+ * @param[in] channels Number of channels of each pixel, from 1 to 4
+ * @param[out] destination First color written
+ * @param[in] count Number of pixels to convert
+ */
+STBIPP_API void srgbToLinear(const unsigned char* source, int channels, Color4f* destination, std::size_t count);
+
+/**
+ * @brief Decode interleaved 16 bits sRGB channels to linear colors through a lookup table
+ * The alpha channel of 2 and 4 channels pixels is only normalized, the missing channels are set to 0.
+ * @param[in] source The channels of each pixel, one after the other
+ * @param[in] channels Number of channels of each pixel, from 1 to 4
+ * @param[out] destination First color written
+ * @param[in] count Number of pixels to convert
+ */
+STBIPP_API void srgbToLinear(const unsigned short* source, int channels, Color4f* destination, std::size_t count);
+
+/**
+ * @brief Decode sRGB colors to linear colors with a fast approximation of the transfer function
+ * With SSE2 instructions the relative error is below 1e-6, without them the exact transfer function is used. source
+ * and destination may be equal.
+ * @param[in] source First color to convert
+ * @param[out] destination First color written
+ * @param[in] count Number of colors to convert
+ * @param[in] colorChannels Number of leading channels converted (1 for gray images), the others are copied
+ */
+STBIPP_API void srgbToLinear(const Color4f* source,
+                             Color4f* destination,
+                             std::size_t count,
+                             unsigned int colorChannels = 3);
+
+/**
+ * @brief Encode linear colors to sRGB colors with a fast approximation of the transfer function
+ * With SSE2 instructions the relative error is below 1e-6, without them the exact transfer function is used. source
+ * and destination may be equal.
+ * @param[in] source First color to convert
+ * @param[out] destination First color written
+ * @param[in] count Number of colors to convert
+ * @param[in] colorChannels Number of leading channels converted (1 for gray images), the others are copied
+ */
+STBIPP_API void linearToSrgb(const Color4f* source,
+                             Color4f* destination,
+                             std::size_t count,
+                             unsigned int colorChannels = 3);
+
+/**
+ * @brief Decode the red, green and blue channels of an sRGB image to linear values, the alpha channel is kept
+ * @param[in,out] image The image to convert
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void srgbToLinear(Image& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Encode the red, green and blue channels of a linear image to sRGB values, the alpha channel is kept
+ * @param[in,out] image The image to convert
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ */
+STBIPP_API void linearToSrgb(Image& image, unsigned int threadCount = 1);
+
+} // namespace stbipp
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief Per channel statistics of an image
+ */
+struct ImageStatistics
+{
+    std::size_t pixelCount{0}; /// Number of pixels, the other values are 0 for an empty image
+    Color4f minimum{};         /// Smallest value of each channel
+    Color4f maximum{};         /// Largest value of each channel
+    Color4f sum{};             /// Sum of each channel, accumulated in double precision
+    Color4f mean{};            /// Average of each channel
+    Color4f variance{};        /// Population variance of each channel
+};
+
+/**
+ * @brief Per channel histogram of an image
+ * The [minimum, maximum] range is split in binCount bins of the same width, values outside the range are counted in
+ * the first or the last bin.
+ */
+struct Histogram
+{
+    float minimum{0.0f};                                 /// Lower bound of the first bin
+    float maximum{1.0f};                                 /// Upper bound of the last bin
+    int binCount{0};                                     /// Number of bins of each channel
+    std::array<std::vector<std::uint64_t>, 4> counts{}; /// Number of values in each bin, for each channel
+};
+
+/**
+ * @brief Compute the minimum, maximum, sum, mean and variance of each channel in a single pass
+ * The pixels are reduced in blocks with the vectorized color operations, the blocks are merged in double precision
+ * with the parallel variance formula so the variance stays accurate on large images. Each task of the thread pool
+ * keeps its own partial result, the partial results are merged at the end.
+ * @param[in] image The image
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @return The statistics
+ */
+STBIPP_API ImageStatistics computeStatistics(const Image& image, unsigned int threadCount = 1);
+
+/**
+ * @brief Count the values of each channel in bins
+ * NaN values are counted in the first bin.
+ * @param[in] image The image
+ * @param[in] binCount Number of bins, greater than 0
+ * @param[in] minimum Lower bound of the first bin
+ * @param[in] maximum Upper bound of the last bin, greater than minimum
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @throw std::invalid_argument if binCount is not positive or the range is empty
+ * @return The histogram
+ */
+STBIPP_API Histogram computeHistogram(const Image& image,
+                                      int binCount = 256,
+                                      float minimum = 0.0f,
+                                      float maximum = 1.0f,
+                                      unsigned int threadCount = 1);
+
+/**
+ * @brief Estimate a percentile of each channel from a histogram
+ * The values of a bin are assumed to be evenly spread over the bin, so the precision is the width of a bin.
+ * @param[in] histogram The histogram
+ * @param[in] fraction The percentile as a fraction in [0, 1] (e.g : 0.5 for the median)
+ * @throw std::invalid_argument if the histogram has no bin or fraction is outside [0, 1]
+ * @return The estimated value of each channel, the histogram minimum for a channel without values
+ */
+STBIPP_API Color4f estimatePercentile(const Histogram& histogram, float fraction);
+
+} // namespace stbipp
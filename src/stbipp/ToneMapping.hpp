@@ -0,0 +1,69 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <cstddef>
+
+namespace stbipp
+{
+/**
+ * @brief The curve compressing the high dynamic range values to [0, 1]
+ */
+enum class ToneMapOperator
+{
+    CLAMP,    /// Values above 1 are clamped
+    REINHARD, /// Reinhard curve x / (1 + x), extended with a white point when it is positive
+    ACES      /// Fit of the ACES filmic curve by Krzysztof Narkowicz
+};
+
+/**
+ * @brief Settings of the tone mapping, the default settings only clamp the values to [0, 1]
+ * The color channels are scaled by the exposure, compressed by the operator, clamped to [0, 1] and raised to the
+ * power 1 / gamma. The alpha channel is left unchanged.
+ */
+struct ToneMapping
+{
+    ToneMapOperator toneMapOperator{ToneMapOperator::CLAMP}; /// Curve applied after the exposure
+    float exposure{0.0f};   /// Exposure in stops, the values are multiplied by 2^exposure
+    float whitePoint{0.0f}; /// Smallest value mapped to 1 by the REINHARD operator, 0 for the simple curve
+    float gamma{1.0f};      /// Gamma of the display, the values are raised to the power 1 / gamma
+
+    /**
+     * @brief Check if the tone mapping only clamps the values
+     * @return true with the CLAMP operator, no exposure and a gamma of 1
+     */
+    bool isClampOnly() const
+    {
+        return toneMapOperator == ToneMapOperator::CLAMP && exposure == 0.0f && gamma == 1.0f;
+    }
+};
+
+/**
+ * @brief Tone map colors to [0, 1]
+ * With SSE2 instructions the gamma uses the fast approximation of pow of the sRGB conversions. source and
+ * destination may be equal.
+ * @param[in] source First color to tone map
+ * @param[out] destination First color written
+ * @param[in] count Number of colors
+ * @param[in] toneMapping Exposure, operator and gamma applied
+ * @param[in] colorChannels Number of leading channels tone mapped (1 for gray images), the others are copied
+ * @throw std::invalid_argument if the gamma is not positive or the white point is negative
+ */
+STBIPP_API void toneMap(const Color4f* source,
+                        Color4f* destination,
+                        std::size_t count,
+                        const ToneMapping& toneMapping,
+                        unsigned int colorChannels = 3);
+
+/**
+ * @brief Tone map the red, green and blue channels of an image in place, the alpha channel is kept
+ * @param[in,out] image The high dynamic range image
+ * @param[in] toneMapping Exposure, operator and gamma applied
+ * @param[in] threadCount Maximum number of threads used, 0 uses all the hardware threads
+ * @throw std::invalid_argument if the gamma is not positive or the white point is negative
+ */
+STBIPP_API void toneMap(Image& image, const ToneMapping& toneMapping, unsigned int threadCount = 1);
+
+} // namespace stbipp
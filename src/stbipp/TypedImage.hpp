@@ -0,0 +1,195 @@
+#pragma once
+
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace stbipp
+{
+/**
+ * @brief The TypedImage class is a 2D pixel matrix storing its pixels with any color type
+ * Unlike Image, which always stores Color4f, a TypedImage keeps the pixels in a compact type (e.g : Color4h for HDR
+ * images, Color3uc for 8 bits images) to save memory and bandwidth. It is converted from and to an Image with
+ * convertPixels.
+ *
+ * @tparam ColorType The color type of the pixels
+ */
+template<class ColorType>
+class TypedImage
+{
+  public:
+    using Color = ColorType;
+    using iterator = typename std::vector<ColorType>::iterator;
+    using const_iterator = typename std::vector<ColorType>::const_iterator;
+
+    /**
+     * @brief Default image constructor
+     */
+    TypedImage() = default;
+
+    /**
+     * @brief Image contructor, resize the image with the given dimensions
+     * @param[in] width The image width
+     * @param[in] height The image height
+     */
+    TypedImage(int width, int height): TypedImage(width, height, ColorType{}) {}
+
+    /**
+     * @brief Image contructor, filling the content with the given color
+     * @param[in] width The image width
+     * @param[in] height The image height
+     * @param[in] color The image will be filled with this color
+     */
+    TypedImage(int width, int height, const ColorType& color)
+    {
+        if(width < 0 || height < 0)
+        {
+            throw std::invalid_argument("New image dimensions must be positive integers!");
+        }
+        m_width = width;
+        m_height = height;
+        m_data.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+        fill(color);
+    }
+
+    /**
+     * @brief Image constructor, convert the pixels of an image
+     * @param[in] image The image to convert
+     */
+    explicit TypedImage(const Image& image): TypedImage(image.width(), image.height())
+    {
+        convertPixels(image.data(), m_data.data(), m_data.size());
+    }
+
+    /**
+     * @brief Convert the pixels to an image
+     * @return The image
+     */
+    Image toImage() const
+    {
+        Image image(m_width, m_height);
+        convertPixels(m_data.data(), image.data(), m_data.size());
+        return image;
+    }
+
+    /**
+     * @brief Access the data of the first element
+     * @return Pointer to the color matrix data
+     */
+    const ColorType* data() const
+    {
+        return m_data.data();
+    }
+
+    /**
+     * @brief Access the data of the first element
+     * @return Pointer to the color matrix data
+     */
+    ColorType* data()
+    {
+        return m_data.data();
+    }
+
+    /**
+     * @brief Fill the image with the given color
+     * @param[in] color The image will be filled with this color
+     */
+    void fill(const ColorType& color)
+    {
+        fillPixels(m_data.data(), m_data.size(), color);
+    }
+
+    /**
+     * @brief Image height getter
+     * @return The image height
+     */
+    int height() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Image width getter
+     * @return The image width
+     */
+    int width() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Accessor to the color at the specified coordinate
+     * @param[in] column The x coordinate
+     * @param[in] row The y coordinate
+     * @return The color at the given coordinate
+     */
+    const ColorType& operator()(int column, int row) const
+    {
+        return m_data[index(column, row)];
+    }
+
+    /**
+     * @brief Accessor to the color at the specified coordinate
+     * @param[in] column The x coordinate
+     * @param[in] row The y coordinate
+     * @return The color at the given coordinate
+     */
+    ColorType& operator()(int column, int row)
+    {
+        return m_data[index(column, row)];
+    }
+
+    iterator begin() noexcept
+    {
+        return m_data.begin();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return m_data.begin();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return m_data.cbegin();
+    }
+
+    iterator end() noexcept
+    {
+        return m_data.end();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return m_data.end();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return m_data.cend();
+    }
+
+  private:
+    std::size_t index(int column, int row) const
+    {
+        if(column >= m_width || column < 0 || row < 0 || row >= m_height)
+        {
+            throw std::out_of_range("Trying to access out of range value");
+        }
+        return static_cast<std::size_t>(row) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(column);
+    }
+
+    std::vector<ColorType> m_data;
+    int m_width{0};
+    int m_height{0};
+};
+
+/**
+ * @brief Image storing 16 bits floating point RGBA pixels, half the size of an Image
+ */
+using HalfImage = TypedImage<Color4h>;
+
+} // namespace stbipp
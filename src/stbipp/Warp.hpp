@@ -0,0 +1,181 @@
+#pragma once
+
+#include "stbipp/BorderMode.hpp"
+#include "stbipp/Color.hpp"
+#include "stbipp/Image.hpp"
+#include "stbipp/Point.hpp"
+#include "stbipp/Sampling.hpp"
+#include "stbipp/StbippSymbols.h"
+
+#include <array>
+
+namespace stbipp
+{
+/**
+ * @brief A 2x3 matrix mapping a position (x, y) to (c0 x + c1 y + c2, c3 x + c4 y + c5)
+ * The y axis grows downwards, so positive rotation angles turn clockwise on screen.
+ */
+struct STBIPP_API AffineTransform
+{
+    std::array<double, 6> coefficients{{1.0, 0.0, 0.0, 0.0, 1.0, 0.0}}; /// Row major coefficients
+
+    /**
+     * @brief Default transform constructor, the identity
+     */
+    AffineTransform() = default;
+
+    /**
+     * @brief Transform constructor
+     * @param[in] coefficients Row major coefficients of the 2x3 matrix
+     */
+    explicit AffineTransform(const std::array<double, 6>& coefficients);
+
+    /**
+     * @brief Create a translation
+     * @param[in] x Horizontal offset in pixels
+     * @param[in] y Vertical offset in pixels
+     * @return The transform
+     */
+    static AffineTransform translation(double x, double y);
+
+    /**
+     * @brief Create a scaling around the origin
+     * @param[in] x Horizontal factor
+     * @param[in] y Vertical factor
+     * @return The transform
+     */
+    static AffineTransform scaling(double x, double y);
+
+    /**
+     * @brief Create a rotation around a center
+     * @param[in] angle Angle in radians, clockwise on screen
+     * @param[in] center The fixed position
+     * @return The transform
+     */
+    static AffineTransform rotation(double angle, const Point2f& center = Point2f{});
+
+    /**
+     * @brief Compute the transform undoing this one
+     * @throw std::invalid_argument if the transform is not invertible
+     * @return The inverse transform
+     */
+    AffineTransform inverse() const;
+
+    /**
+     * @brief Transform a position
+     * @param[in] point The position
+     * @return The transformed position
+     */
+    Point2f apply(const Point2f& point) const;
+};
+
+/**
+ * @brief Compose two transforms
+ * @param[in] lhs The transform applied last
+ * @param[in] rhs The transform applied first
+ * @return The transform applying rhs then lhs
+ */
+STBIPP_API AffineTransform operator*(const AffineTransform& lhs, const AffineTransform& rhs);
+
+/**
+ * @brief A 3x3 projective matrix mapping a position (x, y) to (X / W, Y / W) with (X, Y, W) = M (x, y, 1)
+ */
+struct STBIPP_API PerspectiveTransform
+{
+    std::array<double, 9> coefficients{{1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0}}; /// Row major coefficients
+
+    /**
+     * @brief Default transform constructor, the identity
+     */
+    PerspectiveTransform() = default;
+
+    /**
+     * @brief Transform constructor
+     * @param[in] coefficients Row major coefficients of the 3x3 matrix
+     */
+    explicit PerspectiveTransform(const std::array<double, 9>& coefficients);
+
+    /**
+     * @brief Transform constructor from an affine transform, the last row of the matrix is (0, 0, 1)
+     * @param[in] transform The affine transform
+     */
+    explicit PerspectiveTransform(const AffineTransform& transform);
+
+    /**
+     * @brief Create the transform mapping four positions to four other ones
+     * Used to deskew a scanned page, by mapping the corners of the page in the scan to the corners of an upright
+     * rectangle.
+     * @param[in] source The four positions to map, no three of them aligned
+     * @param[in] destination The four positions they are mapped to, no three of them aligned
+     * @throw std::invalid_argument if the positions don't define a transform
+     * @return The transform
+     */
+    static PerspectiveTransform fromQuadrilaterals(const std::array<Point2f, 4>& source,
+                                                   const std::array<Point2f, 4>& destination);
+
+    /**
+     * @brief Compute the transform undoing this one
+     * @throw std::invalid_argument if the transform is not invertible
+     * @return The inverse transform
+     */
+    PerspectiveTransform inverse() const;
+
+    /**
+     * @brief Transform a position
+     * @param[in] point The position
+     * @return The transformed position, infinite or NaN coordinates for positions sent to infinity
+     */
+    Point2f apply(const Point2f& point) const;
+};
+
+/**
+ * @brief Compose two transforms
+ * @param[in] lhs The transform applied last
+ * @param[in] rhs The transform applied first
+ * @return The transform applying rhs then lhs
+ */
+STBIPP_API PerspectiveTransform operator*(const PerspectiveTransform& lhs, const PerspectiveTransform& rhs);
+
+/**
+ * @brief Settings of the warps
+ */
+struct WarpOptions
+{
+    int width{0};                                /// Width of the result, 0 uses the width of the image
+    int height{0};                               /// Height of the result, 0 uses the height of the image
+    SampleFilter filter{SampleFilter::BILINEAR}; /// Interpolation filter
+    BorderMode border{BorderMode::CONSTANT};     /// How the pixels outside the image are read
+    Color4f borderColor{};                       /// Color of the pixels outside the image with BorderMode::CONSTANT
+    unsigned int threadCount{1};                 /// Maximum number of threads used, 0 uses all the hardware threads
+};
+
+/**
+ * @brief Apply an affine transform to an image
+ * Each pixel of the result samples the image at the position given by the inverse transform, with the conventions of
+ * sample. The rows are computed in bands over several threads, the source position is stepped along each row instead
+ * of being transformed for each pixel.
+ * @param[in] image The image to warp
+ * @param[in] transform Maps the positions of the image to the positions of the result
+ * @param[in] options Result dimensions, filter, border mode and thread count
+ * @throw std::invalid_argument if the transform is not invertible or the result dimensions are negative
+ * @return The warped image
+ */
+STBIPP_API Image warpAffine(const Image& image,
+                            const AffineTransform& transform,
+                            const WarpOptions& options = WarpOptions{});
+
+/**
+ * @brief Apply a perspective transform to an image
+ * The homogeneous source position is stepped along each row and divided for each pixel, the pixels whose position
+ * is sent to infinity get the border color.
+ * @param[in] image The image to warp
+ * @param[in] transform Maps the positions of the image to the positions of the result
+ * @param[in] options Result dimensions, filter, border mode and thread count
+ * @throw std::invalid_argument if the transform is not invertible or the result dimensions are negative
+ * @return The warped image
+ */
+STBIPP_API Image warpPerspective(const Image& image,
+                                 const PerspectiveTransform& transform,
+                                 const WarpOptions& options = WarpOptions{});
+
+} // namespace stbipp